@@ -0,0 +1,123 @@
+// Simulates many independent games at once, each played by a bot, and reports how many games
+// (and ticks) were simulated per second in total, e.g. for balancing. Each world is stepped a
+// slice at a time by tasks on a work-stealing thread pool (see ThreadPool.hpp), and starts a new
+// game whenever its snake dies. World i is seeded with i, so a batch always plays out the same way.
+//
+// usage: snake_batch [worlds [games per world [threads [config]]]]
+// which defaults to 64 worlds, 10 games each, one thread per core, and game.cfg
+
+#include "../main/Config.hpp"
+#include "../main/GameWorld.hpp"
+#include "../main/Random.hpp"
+#include "../main/ThreadPool.hpp"
+#include "../main/ZippedUniqueObjectCollection.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// how many ticks each task steps its world for
+static const unsigned long sliceTicks = 1000;
+// the most game time one game is given, in case the bot never dies
+static const GameWorld::TickType maxTicksPerGame = 10 * 60 * 1000 / GameWorld::tickLength;
+// the bot turns about once every this many ticks
+static const unsigned long botTurnPeriod = 50;
+
+// a game world, and the bot playing it
+struct BotGame
+{
+	ZippedUniqueObjectCollection gameObjects;
+	GameWorld world;
+	Random botRandom;
+	// games finished so far
+	unsigned long games;
+
+	BotGame(const GameWorld::ConfigPtr& config, const unsigned long seed) :
+		world(config, gameObjects, seed), botRandom(seed), games(0)
+	{
+		world.SetCallbacks(GameWorld::SoundCallback(), boost::bind(&BotGame::Lost, this));
+	}
+
+	void Lost()
+	{
+		++games;
+	}
+
+	// turn left or right every so often, at random
+	void Play()
+	{
+		if(botRandom() % botTurnPeriod == 0)
+			world.MouseNotify((botRandom() % 2) ? SDL_BUTTON_LEFT : SDL_BUTTON_RIGHT);
+	}
+};
+
+typedef boost::shared_ptr<BotGame> BotGamePtr;
+
+// step _game_ for a slice, and queue the next slice if it's not done
+static void step_game(ThreadPool& pool, BotGame& game, const unsigned long games)
+{
+	for(unsigned long i = 0; i < sliceTicks && game.games < games; ++i)
+	{
+		game.Play();
+		game.world.Step();
+	}
+
+	if(game.games < games && game.world.GetTick() < games * maxTicksPerGame)
+		pool.Submit(boost::bind(&step_game, boost::ref(pool), boost::ref(game), games));
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned long worldCount = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64;
+	const unsigned long games = (argc > 2) ? strtoul(argv[2], NULL, 10) : 10;
+	const unsigned long threads = (argc > 3) ? strtoul(argv[3], NULL, 10) : boost::thread::hardware_concurrency();
+	const std::string configFilename = (argc > 4) ? argv[4] : "game.cfg";
+
+	const GameWorld::ConfigPtr config(new Config(Config::GetConfigLoader(configFilename)));
+
+	std::vector<BotGamePtr> botGames;
+	botGames.reserve(worldCount);
+	for(unsigned long i = 0; i < worldCount; ++i)
+		botGames.push_back(BotGamePtr(new BotGame(config, i)));
+
+	ThreadPool pool(threads);
+
+	const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+	for(unsigned long i = 0; i < worldCount; ++i)
+		pool.Submit(boost::bind(&step_game, boost::ref(pool), boost::ref(*botGames[i]), games));
+	pool.Wait();
+
+	const double seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+
+	unsigned long totalGames = 0;
+	unsigned long unfinished = 0;
+	GameWorld::TickType ticks = 0;
+	for(unsigned long i = 0; i < worldCount; ++i)
+	{
+		totalGames += botGames[i]->games;
+		unfinished += (botGames[i]->games < games);
+		ticks += botGames[i]->world.GetTick();
+	}
+
+	printf("Simulated %lu games (%llu ticks) in %lu worlds on %lu threads in %.3fs: %.1f games/s, %.0f ticks/s\n",
+		totalGames, ticks, worldCount, pool.GetThreadCount(), seconds,
+		(seconds > 0) ? totalGames / seconds : 0.0, (seconds > 0) ? ticks / seconds : 0.0);
+	if(unfinished > 0)
+		printf("%lu worlds ran out of time before finishing their games\n", unfinished);
+
+	return 0;
+}
@@ -0,0 +1,69 @@
+// Compiles a text config (see CONFIG in the README) into the flat binary form which
+// Config::ConfigScope::LoadCompiled maps in directly, so the game doesn't have to parse it.
+//
+// usage: config_compiler [config [output [level]]]
+// which defaults to compiling game.cfg to game.cfgc. If _level_ is given, the config's walls are
+// also written there as a level file (see Level), which world.level can then point at.
+
+#include "../main/Config.hpp"
+#include "../main/Level.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+int main(int argc, char** argv)
+{
+	const std::string inputFilename = (argc > 1) ? argv[1] : "game.cfg";
+	const std::string outputFilename = (argc > 2) ? argv[2] : Config::GetCompiledFilename(inputFilename);
+
+	std::ifstream input(inputFilename.c_str(), std::ios::binary);
+	if(!input.is_open())
+	{
+		fprintf(stderr, "Unable to open \"%s\"\n", inputFilename.c_str());
+		return 1;
+	}
+
+	const Config::ConfigScope config(input);
+
+	std::ofstream output(outputFilename.c_str(), std::ios::binary);
+	config.WriteCompiled(output);
+	output.close();
+
+	if(!output)
+	{
+		fprintf(stderr, "Unable to write \"%s\"\n", outputFilename.c_str());
+		return 1;
+	}
+
+	printf("Compiled \"%s\" to \"%s\"\n", inputFilename.c_str(), outputFilename.c_str());
+
+	if(argc > 3)
+	{
+		const std::string levelFilename = argv[3];
+		const Level level((Config(config)));
+
+		std::ofstream levelOutput(levelFilename.c_str(), std::ios::binary);
+		level.Write(levelOutput);
+		levelOutput.close();
+
+		if(!levelOutput)
+		{
+			fprintf(stderr, "Unable to write \"%s\"\n", levelFilename.c_str());
+			return 1;
+		}
+
+		printf("Wrote %lu walls in %lu chunks to \"%s\"\n", level.GetWallCount(), level.GetChunkCount(),
+			levelFilename.c_str());
+	}
+
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include "AliasTable.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+AliasTable::AliasTable()
+{
+}
+
+AliasTable::AliasTable(const std::vector<double>& weights) :
+	probabilities(weights.size(), 1), aliases(weights.size())
+{
+	const unsigned long size = weights.size();
+
+	double total = 0;
+	for(unsigned long i = 0; i < size; ++i)
+		total += std::max(weights[i], 0.0);
+
+	// each outcome's weight, scaled so that a full column is 1
+	std::vector<double> scaled(size, 1);
+	if(total > 0)
+		for(unsigned long i = 0; i < size; ++i)
+			scaled[i] = std::max(weights[i], 0.0) * size / total;
+
+	// the outcomes which don't fill their own column, and the ones which overfill it
+	std::vector<unsigned long> under, over;
+	for(unsigned long i = 0; i < size; ++i)
+	{
+		aliases[i] = i;
+		(scaled[i] < 1 ? under : over).push_back(i);
+	}
+
+	// top up an underfull column with an overfull outcome, until there are none of one or the other
+	while(!under.empty() && !over.empty())
+	{
+		const unsigned long small = under.back();
+		const unsigned long large = over.back();
+		under.pop_back();
+
+		probabilities[small] = scaled[small];
+		aliases[small] = large;
+
+		scaled[large] -= 1 - scaled[small];
+		if(scaled[large] < 1)
+		{
+			over.pop_back();
+			under.push_back(large);
+		}
+	}
+
+	// anything left over only misses 1 by rounding error, so it keeps its whole column
+}
+
+unsigned long AliasTable::GetSize() const
+{
+	return probabilities.size();
+}
+
+// a number in [0, 1) from two draws of _random_, so that it has about as many bits as a double does
+static inline double get_uniform(Random& random)
+{
+	const double range = static_cast<double>(Random::max()) - Random::min() + 1;
+	const double high = random() - Random::min();
+	const double low = random() - Random::min();
+
+	return (high + low / range) / range;
+}
+
+unsigned long AliasTable::Sample(Random& random) const
+{
+	const unsigned long size = GetSize();
+	const double x = get_uniform(random) * size;
+
+	// the whole part picks the column, and the fraction where in the column the pick lands
+	const unsigned long column = std::min(static_cast<unsigned long>(x), size - 1);
+	return (x - column < probabilities[column]) ? column : aliases[column];
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Random.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// picks one of a fixed set of outcomes at random, each with its own weight, in constant time
+// however many outcomes there are (Walker's alias method). Every outcome gets an equal-sized
+// column, split between it and one other outcome (its alias), so picking is one column and one
+// coin toss.
+class AliasTable
+{
+private:
+	// the odds that a pick landing in each column stays there, rather than going to its alias
+	std::vector<double> probabilities;
+	std::vector<unsigned long> aliases;
+
+public:
+	// no outcomes; Sample() can't be used until there are some
+	AliasTable();
+	// outcome i has weight _weights_[i]. Negative weights count as 0, and if all the weights are 0,
+	// all outcomes are equally likely.
+	explicit AliasTable(const std::vector<double>& weights);
+
+	// the number of outcomes
+	unsigned long GetSize() const;
+
+	// pick an outcome, using _random_
+	unsigned long Sample(Random& random) const;
+};
@@ -1,9 +1,18 @@
 #pragma once
 
+#include "Direction.hpp"
+#include "Line.hpp"
 #include "Point.hpp"
 
-class Direction;
-struct Line;
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <cassert>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
 
 // define the bounds of a rectangle
 struct Bounds
@@ -18,9 +27,94 @@ struct Bounds
 
 	// shift by a vector
 	Bounds& operator+=(Vector2D);
+
+	// whether any pixel is in both this and _bounds_
+	bool Overlaps(const Bounds& bounds) const;
 	
 	// get the _whichSide_ side of this rectangle
 	Line GetSide(Direction whichSide) const;
 	// set the _whichSide_ side of this rectangle
 	void SetSide(Line sideBounds, Direction whichSide);
 };
+
+BOOST_STATIC_ASSERT(sizeof(Bounds) == 16);
+
+inline Bounds::Bounds()
+{
+}
+
+inline Bounds::Bounds(const Point _min, const Point _max) :
+	min(_min), max(_max)
+{
+}
+
+inline Bounds::Bounds(const Line side) :
+	min(side.min), max(side.min)
+{
+	if(side.horizontal)
+		max.x += side.length;
+	else
+		max.y += side.length;
+}
+
+inline Bounds::operator Line() const
+{
+	// to be a line, one dimension must be 0
+	assert(min.x == max.x || min.y == max.y);
+
+	Line retval;
+	retval.min = min;
+	retval.horizontal = (min.x != max.x);
+	retval.length = retval.horizontal ? max.x - min.x : max.y - min.y;
+
+	return retval;
+}
+
+inline Bounds& Bounds::operator+=(const Vector2D v)
+{
+	min += v;
+	max += v;
+
+	return *this;
+}
+
+inline bool Bounds::Overlaps(const Bounds& bounds) const
+{
+	return min.x < bounds.max.x && bounds.min.x < max.x && min.y < bounds.max.y && bounds.min.y < max.y;
+}
+
+// the sides are picked by indexing with the bits of the direction, rather than by branching on it
+
+inline Line Bounds::GetSide(const Direction whichSide) const
+{
+	const unsigned int positive = whichSide.GetValue() & Direction::positiveBit;
+	const unsigned int vertical = (whichSide.GetValue() & Direction::verticalBit) >> 1;
+
+	const Point::Coordinate xs[] = {min.x, max.x};
+	const Point::Coordinate ys[] = {min.y, max.y};
+	const Point::Coordinate lengths[] = {max.y - min.y, max.x - min.x};
+
+	// the left and right sides are vertical, at the min or max x,
+	// and the top and bottom sides are horizontal, at the min or max y
+	Line side;
+	side.min = Point(xs[positive & (vertical ^ 1)], ys[positive & vertical]);
+	side.length = lengths[vertical];
+	side.horizontal = (vertical != 0);
+
+	return side;
+}
+
+inline void Bounds::SetSide(const Line side, const Direction whichSide)
+{
+	const unsigned int positive = whichSide.GetValue() & Direction::positiveBit;
+	const unsigned int vertical = (whichSide.GetValue() & Direction::verticalBit) >> 1;
+
+	Point::Coordinate* const coordinates[2][2] = {{&min.x, &max.x}, {&min.y, &max.y}};
+	const Point::Coordinate sideMin[] = {side.min.x, side.min.y};
+
+	// the side's own coordinate along _whichSide_'s axis
+	*coordinates[vertical][positive] = sideMin[vertical];
+	// and its extent across it
+	*coordinates[vertical ^ 1][0] = sideMin[vertical ^ 1];
+	*coordinates[vertical ^ 1][1] = sideMin[vertical ^ 1] + side.length;
+}
@@ -0,0 +1,51 @@
+#include "Camera.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Graphics
+{
+	Camera::Camera(const Point _viewSize) :
+		viewSize(_viewSize), origin(0, 0)
+	{
+	}
+
+	// where the view should start along an axis, to center it on [_min_, _max_) within [0, _worldSize_)
+	static inline Point::Coordinate follow_axis(const Point::Coordinate min, const Point::Coordinate max,
+		const Point::Coordinate worldSize, const Point::Coordinate viewSize)
+	{
+		if(worldSize <= viewSize)
+			return (worldSize - viewSize) / 2;
+
+		const Point::Coordinate centered = (min + max) / 2 - viewSize / 2;
+		return std::min(std::max<Point::Coordinate>(centered, 0), worldSize - viewSize);
+	}
+
+	void Camera::Follow(const Bounds& focus, const Point worldSize)
+	{
+		origin.x = follow_axis(focus.min.x, focus.max.x, worldSize.x, viewSize.x);
+		origin.y = follow_axis(focus.min.y, focus.max.y, worldSize.y, viewSize.y);
+	}
+
+	Point Camera::GetOrigin() const
+	{
+		return origin;
+	}
+
+	Bounds Camera::GetView() const
+	{
+		return Bounds(origin, origin + viewSize);
+	}
+
+	Bounds Camera::ToScreen(const Bounds& bounds) const
+	{
+		return Bounds(bounds.min - origin, bounds.max - origin);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Bounds.hpp"
+#include "Point.hpp"
+
+namespace Graphics
+{
+	// The part of the world that's on the screen. World coordinates are independent of the screen, so
+	// the world can be any size; the camera keeps the snake's head in the middle of the view, except
+	// near the edges of the world, where it stops so as not to show anything past them.
+	class Camera
+	{
+	private:
+		Point viewSize;
+		// the world point at the top-left corner of the screen
+		Point origin;
+
+	public:
+		// show _viewSize_ (the screen size) worth of the world at a time
+		explicit Camera(Point viewSize);
+
+		// center the view on _focus_, as far as the edges of a _worldSize_ world allow. Worlds
+		// smaller than the view are centered in it.
+		void Follow(const Bounds& focus, Point worldSize);
+
+		Point GetOrigin() const;
+		// the part of the world in view
+		Bounds GetView() const;
+		// _bounds_ (in the world) in screen coordinates
+		Bounds ToScreen(const Bounds& bounds) const;
+	};
+}
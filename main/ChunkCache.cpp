@@ -0,0 +1,137 @@
+#include "ChunkCache.hpp"
+
+#include "Logger.hpp"
+#include "OccupancyGrid.hpp"
+#include "Profiler.hpp"
+#include "ZippedUniqueObjectCollection.hpp"
+
+ChunkCache::ChunkCache() :
+	level(NULL), budget(0), loadedBytes(0), updateCount(0)
+{
+}
+
+unsigned long ChunkCache::GetSize(const Chunk& chunk)
+{
+	return sizeof(Chunk) + chunk.walls.capacity() * sizeof(Wall);
+}
+
+void ChunkCache::Load(const ChunkIndex index, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy)
+{
+	loaded.push_front(Chunk());
+	Chunk& chunk = loaded.front();
+	chunk.index = index;
+	chunk.lastNeeded = updateCount;
+	lookup[index] = loaded.begin();
+
+	const Level::Compiled::Chunk& records = level->GetChunk(index);
+	chunk.walls.reserve(records.wallCount);
+	for(const Level::Compiled::Wall* wall = level->GetWalls() + records.firstWall, * const end = wall + records.wallCount;
+		wall != end; ++wall)
+	{
+		chunk.walls.push_back(Wall(wall->GetBounds(), wall->GetColor()));
+		occupancy.Set(wall->GetBounds());
+	}
+
+	// the walls are only drawn, not collided with, so they aren't physics objects
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		gameObjects.graphics.AddRange(chunk.walls.begin(), chunk.walls.end());
+	)
+
+	loadedBytes += GetSize(chunk);
+	LOGDEBUG(boost::format("Loaded chunk %1% (%2% walls)") % index % chunk.walls.size())
+}
+
+void ChunkCache::Evict(const ChunkList::iterator chunk, ZippedUniqueObjectCollection& gameObjects,
+	OccupancyGrid& occupancy)
+{
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		gameObjects.graphics.RemoveRange(chunk->walls.begin(), chunk->walls.end());
+	)
+
+	// walls are split along chunk boundaries, so none of the other chunks' walls are in here
+	occupancy.Unset(level->GetChunkBounds(chunk->index));
+
+	LOGDEBUG(boost::format("Evicted chunk %1%") % chunk->index)
+	loadedBytes -= GetSize(*chunk);
+	lookup[chunk->index] = loaded.end();
+	loaded.erase(chunk);
+}
+
+void ChunkCache::SetLevel(const Level* const _level, ZippedUniqueObjectCollection& gameObjects,
+	OccupancyGrid& occupancy)
+{
+	while(!loaded.empty())
+		Evict(loaded.begin(), gameObjects, occupancy);
+
+	level = _level;
+	lookup.assign(level->GetChunkCount(), loaded.end());
+	needed.clear();
+}
+
+void ChunkCache::SetBudget(const unsigned long _budget)
+{
+	budget = _budget;
+}
+
+void ChunkCache::Update(const Bounds& region, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy,
+	std::vector<Bounds>& cleared)
+{
+	PROFILESCOPE(chunkUpdate)
+
+	++updateCount;
+
+	needed.clear();
+	level->GetChunks(region, needed);
+	for(ChunkIndexArray::const_iterator i = needed.begin(), end = needed.end(); i != end; ++i)
+	{
+		if(lookup[*i] == loaded.end())
+			Load(*i, gameObjects, occupancy);
+		else
+		{
+			lookup[*i]->lastNeeded = updateCount;
+			loaded.splice(loaded.begin(), loaded, lookup[*i]);
+		}
+	}
+
+	// the chunks needed now are all at the front, so they're never evicted, however small the budget
+	while(loadedBytes > budget && !loaded.empty() && loaded.back().lastNeeded != updateCount)
+	{
+		cleared.push_back(level->GetChunkBounds(loaded.back().index));
+		Evict(--loaded.end(), gameObjects, occupancy);
+	}
+}
+
+void ChunkCache::Clear(ZippedUniqueObjectCollection& gameObjects)
+{
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		for(ChunkList::iterator i = loaded.begin(), end = loaded.end(); i != end; ++i)
+			gameObjects.graphics.RemoveRange(i->walls.begin(), i->walls.end());
+	)
+
+	loaded.clear();
+	lookup.assign(lookup.size(), loaded.end());
+	loadedBytes = 0;
+	needed.clear();
+}
+
+const ChunkCache::ChunkIndexArray& ChunkCache::GetNeeded() const
+{
+	return needed;
+}
+
+void ChunkCache::SetOccupancy(OccupancyGrid& occupancy) const
+{
+	for(ChunkList::const_iterator i = loaded.begin(), end = loaded.end(); i != end; ++i)
+		for(std::vector<Wall>::const_iterator wall = i->walls.begin(), wallsEnd = i->walls.end(); wall != wallsEnd; ++wall)
+			occupancy.Set(wall->GetBounds());
+}
+
+unsigned long ChunkCache::GetLoadedCount() const
+{
+	return loaded.size();
+}
+
+unsigned long ChunkCache::GetLoadedBytes() const
+{
+	return loadedBytes;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Level.hpp"
+#include "Wall.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/noncopyable.hpp>
+#include <list>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+class OccupancyGrid;
+struct ZippedUniqueObjectCollection;
+
+// The chunks of a level which are loaded: their walls exist as Wall objects, in the game objects'
+// graphics collection (for drawing) and in the occupancy grid (for collisions), which is all that
+// either ever sees of the level. Chunks that stop being needed stay loaded until the loaded chunks take
+// up more than a memory budget, and then the ones that were needed least recently are evicted.
+// Only the loaded chunks are in the occupancy grid, so the snake has to stay well inside the needed
+// region (see GameWorld::StreamChunks).
+class ChunkCache : private boost::noncopyable
+{
+public:
+	typedef Level::Compiled::Index ChunkIndex;
+	typedef std::vector<ChunkIndex> ChunkIndexArray;
+
+private:
+	struct Chunk
+	{
+		ChunkIndex index;
+		// the Update() this was last needed in
+		unsigned long long lastNeeded;
+		// never resized once loaded, since the game objects point into it
+		std::vector<Wall> walls;
+	};
+	// most recently needed first
+	typedef std::list<Chunk> ChunkList;
+
+	const Level* level;
+	unsigned long budget;
+
+	ChunkList loaded;
+	// where each of the level's chunks is in _loaded_ (or _loaded_.end(), if it isn't loaded)
+	std::vector<ChunkList::iterator> lookup;
+	unsigned long loadedBytes;
+	// the number of Update()s so far
+	unsigned long long updateCount;
+
+	// the chunks needed by the current Update(), kept between updates for its capacity
+	ChunkIndexArray needed;
+
+	void Load(ChunkIndex chunk, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy);
+	// evict _chunk_, clearing its area of _occupancy_
+	void Evict(ChunkList::iterator chunk, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy);
+	// the bytes _chunk_ takes up while it's loaded
+	static unsigned long GetSize(const Chunk& chunk);
+
+public:
+	ChunkCache();
+
+	// evict everything, and start using _level_ (which must outlive this, or the next SetLevel())
+	void SetLevel(const Level* level, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy);
+	// evict the least recently needed chunks while the loaded ones take up more than _budget_ bytes
+	void SetBudget(unsigned long budget);
+
+	// Load every chunk that overlaps _region_, then evict chunks this didn't need (least recently needed
+	// first) until they fit the budget. The areas of any evicted chunks are cleared in _occupancy_, and
+	// appended to _cleared_, since anything else there (i.e. the snake) has to be put back.
+	void Update(const Bounds& region, ZippedUniqueObjectCollection& gameObjects, OccupancyGrid& occupancy,
+		std::vector<Bounds>& cleared);
+	// evict every chunk, without touching the occupancy grid (e.g. because it's about to be rebuilt)
+	void Clear(ZippedUniqueObjectCollection& gameObjects);
+
+	// the chunks which overlapped the last Update()'s region, row by row
+	const ChunkIndexArray& GetNeeded() const;
+	// set every loaded wall in _occupancy_
+	void SetOccupancy(OccupancyGrid& occupancy) const;
+
+	unsigned long GetLoadedCount() const;
+	unsigned long GetLoadedBytes() const;
+};
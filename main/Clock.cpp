@@ -1,49 +1,21 @@
 #include "Clock.hpp"
 
-Clock Clock::gameClock;
-
-static inline clock_t get_raw_time()
-{
-	return clock();
-}
-
-void Clock::UpdateTime()
-{
-	const clock_t rawTime = get_raw_time();
-	const clock_t deltaT = (rawTime - lastTime) * 1000 / CLOCKS_PER_SEC;
-
-	time += deltaT;
-	lastTime = rawTime;
-}
-
-Clock& Clock::Get()
-{
-	return gameClock;
-}
-
-Clock::Clock()
+Clock::Clock() :
+	time(0)
 {
-	paused = false;
-	time = 0;
-	lastTime = get_raw_time();
 }
 
-Clock::TimeType Clock::GetTime()
+Clock::TimeType Clock::GetTime() const
 {
-	if(!paused)
-		UpdateTime();
-
-	return time;
+	return time.load(boost::memory_order_relaxed);
 }
 
-void Clock::Pause()
+void Clock::Advance(const TimeType ms)
 {
-	paused = true;
-	UpdateTime();
+	time.store(time.load(boost::memory_order_relaxed) + ms, boost::memory_order_relaxed);
 }
 
-void Clock::Unpause()
+void Clock::SetTime(const TimeType _time)
 {
-	paused = false;
-	lastTime = get_raw_time();
+	time.store(_time, boost::memory_order_relaxed);
 }
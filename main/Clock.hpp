@@ -4,35 +4,31 @@
 #pragma warning(push, 0)
 #endif
 
-#include <ctime>
+#include <boost/atomic.hpp>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-// keeps track of game time (starting at 0)
+// keeps track of game time (starting at 0). Each game world has its own clock, which
+// only moves when the world steps, so that a game plays out the same way no matter
+// how fast it's simulated (see GameWorld::Step).
 class Clock
 {
 public:
 	typedef unsigned long long TimeType;
 
 private:
-	bool paused;
-	TimeType time;
-	// the time state, at the last time the time was requested
-	clock_t lastTime;
-	
-	static Clock gameClock;
-	
-	Clock();
-	void UpdateTime();
+	// only advanced by the thread stepping the world, but read from everywhere
+	boost::atomic<TimeType> time;
 
 public:
-	// get the (only) clock 
-	static Clock& Get();
+	Clock();
 
-	TimeType GetTime();
+	TimeType GetTime() const;
 
-	void Pause();
-	void Unpause();
+	// move the time forward by _ms_
+	void Advance(TimeType ms);
+	// jump straight to _time_ (e.g. when restoring a snapshot)
+	void SetTime(TimeType time);
 };
@@ -1,20 +1,23 @@
 #include "Config.hpp"
 
+#include "Bounds.hpp"
 #include "Logger.hpp"
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <fstream>
 #include <istream>
+#include <sstream>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-const Config Config::gameConfig(Config::GetConfigLoader("game.cfg"));
-
 static inline std::string get_wall_data_name(const unsigned short i, const char* const specifier)
 {
 	std::stringstream s;
@@ -25,19 +28,40 @@ static inline std::string get_wall_data_name(const unsigned short i, const char*
 	return s.str();
 }
 
-const Config& Config::Get()
+// true iff _compiledFilename_ exists, and was written after _filename_ was last changed
+static bool is_compiled_up_to_date(const std::string& compiledFilename, const std::string& filename)
+{
+	boost::system::error_code error;
+	const std::time_t compiledTime = boost::filesystem::last_write_time(compiledFilename, error);
+	if(error)
+		return false;
+
+	const std::time_t time = boost::filesystem::last_write_time(filename, error);
+	return (error || compiledTime >= time);
+}
+
+std::string Config::GetCompiledFilename(const std::string& filename)
 {
-	return gameConfig;
+	return filename + "c";
 }
 
 const Config::ConfigScope Config::GetConfigLoader(const std::string& filename)
 {
+	// skip parsing altogether if there's an up-to-date compiled config
+	const std::string compiledFilename = GetCompiledFilename(filename);
+	if(is_compiled_up_to_date(compiledFilename, filename))
+	{
+		const std::auto_ptr<ConfigScope> compiled(ConfigScope::LoadCompiled(compiledFilename));
+		if(compiled.get() != NULL)
+			return *compiled;
+	}
+
 	std::ifstream configFile(filename.c_str());
 	if(configFile.is_open())
 		return Config::ConfigScope(configFile);
 
-	std::stringstream defaultConfig(GetDefaultConfig());
-	return Config::ConfigScope(defaultConfig);
+	LOGDEBUG(boost::format("Unable to open config \"%1%\", using the default config") % filename)
+	return Config::ConfigScope(GetDefaultConfig());
 }
 
 Config::ColorConfig::operator Color24() const
@@ -50,8 +74,8 @@ Config::BoundsConfig::operator Bounds() const
 	return Bounds(min, max);
 }
 
-Config::Config(const ConfigScope in) :
-	wallsConfig("walls", "wall", &in), screen(&in), spawns(&in), snake(&in), resources(&in)
+Config::Config(const ConfigScope& in) :
+	wallsConfig("walls", "wall", &in), screen(&in), world(&in, screen), spawns(&in), snake(&in), resources(&in)
 {
 	in.GetField("music", music);
 	in.GetField("sound", sound);
@@ -61,9 +85,9 @@ Config::Config(const ConfigScope in) :
 	in.GetField("pointGainAmount", pointGainAmount);
 }
 
-Config::ConfigLoadable::ConfigLoadable(const std::string& scopeName, const ConfigScope*& in)
+Config::ConfigLoadable::ConfigLoadable(const std::string& scopeName, const ConfigScope*& in, const unsigned long index)
 {
-	in = in->GetScope(scopeName);
+	in = in->GetScope(scopeName, index);
 }
 
 
@@ -112,8 +136,8 @@ Config::Resources::Resources(const ConfigScope* in) :
 	in->GetField("theme", theme);
 }
 
-Config::WallConfig::WallConfig(const ConfigScope* in) :
-	ConfigLoadable("wall", in), bounds(in), color(in)
+Config::WallConfig::WallConfig(const ConfigScope* in, const unsigned long index) :
+	ConfigLoadable("wall", in, index), bounds(in), color(in)
 {
 }
 
@@ -124,6 +148,20 @@ Config::ScreenConfig::ScreenConfig(const ConfigScope* in) :
 	in->GetField("h", h);
 }
 
+Config::WorldConfig::WorldConfig(const ConfigScope* in, const ScreenConfig& screen) :
+	ConfigLoadable("world", in), w(screen.w), h(screen.h), chunkSize(512), chunkBudget(4 << 20)
+{
+	// configs from before worlds could be bigger than the screen have no world scope
+	if(in == NULL)
+		return;
+
+	in->GetField("w", w);
+	in->GetField("h", h);
+	in->GetField("chunkSize", chunkSize);
+	in->GetField("chunkBudget", chunkBudget);
+	in->GetField("level", level);
+}
+
 template <typename _T>
 static void add_to_spawns(Config::SpawnCollectionConfig::SpawnCollection& spawns, const _T& spawn)
 {
@@ -140,10 +178,27 @@ Config::SpawnCollectionConfig::SpawnCollectionConfig(const ConfigScope* in) :
 	const LoadableCollection<MineConfig> mines("mines", "mine", in);
 	for_each(foods.begin(), foods.end(), boost::bind(&add_to_spawns<FoodConfig>, boost::ref(spawnsConfig), _1));
 	for_each(mines.begin(), mines.end(), boost::bind(&add_to_spawns<MineConfig>, boost::ref(spawnsConfig), _1));
+
+	std::vector<double> rates;
+	double totalRate = 0;
+	for(SpawnCollection::const_iterator i = spawnsConfig.begin(), end = spawnsConfig.end(); i != end; ++i)
+	{
+		rates.push_back((*i)->rate);
+		totalRate += (*i)->rate;
+	}
+
+	// if the rates add up to more than 1, they're scaled down to add up to 1. Rates that add up to 1 can
+	// come out a rounding error over it.
+	if(totalRate > 1 + 1e-9)
+		LOGDEBUG(boost::format("Spawn rates add up to %1%; scaling them down to 1") % totalRate)
+	rates.push_back(std::max(1 - totalRate, 0.0));
+
+	spawnTable = AliasTable(rates);
 }
 
-Config::SpawnCollectionConfig::SpawnConfig::SpawnConfig(const std::string& scopeName, const ConfigScope*& in) :
-	ConfigLoadable(scopeName, in), color(in)
+Config::SpawnCollectionConfig::SpawnConfig::SpawnConfig(const std::string& scopeName, const ConfigScope*& in,
+	const unsigned long index) :
+	ConfigLoadable(scopeName, in, index), color(in)
 {
 	in->GetField("size", size);
 	in->GetField("cushion", cushion);
@@ -151,15 +206,15 @@ Config::SpawnCollectionConfig::SpawnConfig::SpawnConfig(const std::string& scope
 	in->GetField("rate", rate);
 }
 
-Config::SpawnCollectionConfig::FoodConfig::FoodConfig(const ConfigScope* in) :
-	SpawnConfig("food", in)
+Config::SpawnCollectionConfig::FoodConfig::FoodConfig(const ConfigScope* in, const unsigned long index) :
+	SpawnConfig("food", in, index)
 {
 	in->GetField("points", points);
 	in->GetField("lengthFactor", lengthFactor);
 	in->GetField("speedChange", speedChange);
 }
 
-Config::SpawnCollectionConfig::MineConfig::MineConfig(const ConfigScope* in) :
-	SpawnConfig("mine", in)
+Config::SpawnCollectionConfig::MineConfig::MineConfig(const ConfigScope* in, const unsigned long index) :
+	SpawnConfig("mine", in, index)
 {
 }
@@ -1,18 +1,26 @@
 #pragma once
 
+#include "AliasTable.hpp"
+#include "Clock.hpp"
 #include "Color24.hpp"
 #include "Point.hpp"
-#include "GameWorld.hpp"
 #include "Logger.hpp"
 
 struct Bounds;
 class ConfigScope;
+class EntityStore;
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <istream>
+#include <memory>
+#include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifdef MSVC
@@ -26,89 +34,200 @@ struct Config
 	class ConfigScope
 	{
 	public:
-		class ScopeCollection
+		// a whitespace-delimited piece of the config text. Tokens are views
+		// into the text itself, so they're only valid as long as it is.
+		struct Token
 		{
-		public:
-			// a simple collection of same-typed scopes
-			typedef std::vector<ConfigScope> RawScopeCollection;
+			const char* begin;
+			unsigned long length;
+
+			Token();
+			Token(const char* begin, unsigned long length);
+
+			bool operator==(const Token& token) const;
+			bool operator==(const char* str) const;
+			bool operator==(const std::string& str) const;
+
+			std::string GetString() const;
+
+			// parse this token as a decimal number, returning false (and leaving
+			// _dest_ unchanged) if it isn't one, or if it's out of range
+			bool ToInteger(long long& dest) const;
+			bool ToUnsigned(unsigned long long& dest) const;
+			bool ToDouble(double& dest) const;
+		};
 
+		// splits config text into Tokens, without copying any of it
+		class Tokenizer
+		{
 		private:
-			RawScopeCollection collection;
-			mutable unsigned long lastIndex;
+			const char* position;
+			const char* end;
 
 		public:
-			ScopeCollection();
+			Tokenizer(const char* begin, const char* end);
 
-			void Add(const ConfigScope& elem);
-			// return true iff there is a scope to be gotten
-			bool HasNextScope() const;
-			// get the next scope, and advance the "next" pointer
-			const ConfigScope& GetNextScope() const;
+			// get the next token, returning false if there are none left
+			bool Next(Token& token);
 		};
 
-		// map field name to field value
-		typedef std::map<std::string, std::string> FieldMap;
-		// map scope name to scope collection
-		typedef std::map<std::string, ScopeCollection> ScopeMap;
+		// The flat form of a parsed config, which is also the layout of a compiled config file
+		// (see config_compiler). Records are fixed-size, and refer to each other (and to the
+		// string pool) by index, so a compiled config can be used in place once it's mapped in.
+		// A file is laid out as: Header, Field[fieldCount], Scope[scopeCount], Group[groupCount],
+		// Index[childCount], char[stringsSize]. The root scope is scope 0.
+		struct Compiled
+		{
+			typedef boost::uint32_t Index;
+
+			enum
+			{
+				magic = 0x43464e53,
+				// bump whenever the layout changes; files of other versions are rejected
+				version = 1
+			};
+
+			struct Header
+			{
+				Index magic;
+				Index version;
+				Index fieldCount;
+				Index scopeCount;
+				Index groupCount;
+				Index childCount;
+				Index stringsSize;
+				Index padding;
+			};
+
+			// a piece of the string pool
+			struct String
+			{
+				Index offset;
+				Index length;
+			};
+
+			struct Field
+			{
+				enum Flags
+				{
+					hasInteger = 1,
+					hasUnsigned = 2,
+					hasReal = 4
+				};
+
+				String name;
+				String value;
+
+				// _value_, converted ahead of time to each type it's valid as (see _flags_)
+				boost::int64_t integer;
+				boost::uint64_t unsignedInteger;
+				double real;
+				Index flags;
+				Index padding;
+			};
+
+			// the same-named subscopes of a scope
+			struct Group
+			{
+				String name;
+				// range of the children array
+				Index firstChild;
+				Index childCount;
+			};
+
+			struct Scope
+			{
+				Index firstField;
+				Index fieldCount;
+				Index firstGroup;
+				Index groupCount;
+			};
+		};
+
+		// holds the records of a whole config, however they were loaded (see Config__ConfigScope.cpp)
+		class Tree;
 
 	private:
-		// _bracketCount_ is the count of curly braces
-		ConfigScope(std::istream& configInput, long& bracketCount);
+		// held by root scopes only, so that the tree lives as long as any copy of its root
+		boost::shared_ptr<const Tree> owner;
+		const Tree* tree;
+		Compiled::Index index;
+
+		ConfigScope(const Tree* tree, Compiled::Index index);
+		ConfigScope(const boost::shared_ptr<const Tree>& tree);
 
-		void Init(std::istream& configInput, long& bracketCount);
+		const Compiled::Field* FindField(const std::string& fieldName) const;
+		const Compiled::Group* FindGroup(const std::string& scopeName) const;
+		std::string GetString(const Compiled::String& string) const;
 
-		// recurse into another configuration scope
-		void EnterScope(std::istream&, long& bracketCount);
+		template <typename _T>
+		void ParseValue(const Compiled::Field& field, _T& dest) const
+		{
+			// _T is signed iff -1 is negative as a _T
+			if(static_cast<_T>(-1) < 0)
+			{
+				if(field.flags & Compiled::Field::hasInteger)
+				{
+					dest = static_cast<_T>(field.integer);
+					return;
+				}
+			}
+			else if(field.flags & Compiled::Field::hasUnsigned)
+			{
+				dest = static_cast<_T>(field.unsignedInteger);
+				return;
+			}
 
-		FieldMap fields;
-		ScopeMap subscopes;
+			LOGDEBUG(boost::format("Invalid integer \"%1%\"") % GetString(field.value))
+		}
+		void ParseValue(const Compiled::Field& field, double& dest) const
+		{
+			if(field.flags & Compiled::Field::hasReal)
+				dest = field.real;
+			else
+				LOGDEBUG(boost::format("Invalid number \"%1%\"") % GetString(field.value))
+		}
 
 	public:
 		ConfigScope(std::istream& configInput);
-
-		bool PeekScope(const std::string& scopeName) const;
-		const ConfigScope* GetScope(const std::string& scopeName) const;
+		ConfigScope(const std::string& configText);
+
+		// map in a config compiled by config_compiler, returning NULL if _filename_ isn't a valid one
+		static std::auto_ptr<ConfigScope> LoadCompiled(const std::string& filename);
+		// write the whole config this scope belongs to in compiled form
+		void WriteCompiled(std::ostream& out) const;
+
+		// get the number of subscopes named _scopeName_
+		unsigned long CountScopes(const std::string& scopeName) const;
+		// get the _index_th subscope named _scopeName_ (in order of appearance), or NULL if there isn't one.
+		// Scopes are never changed once loaded, so this can be done any number of times, from any thread.
+		const ConfigScope* GetScope(const std::string& scopeName, unsigned long index = 0) const;
 	
 		// get _fieldName_'s value in the current scope and store in _dest_
 		template <typename _T>
 		void GetField(const std::string& fieldName, _T& dest) const
 		{
-			const FieldMap::const_iterator result = fields.find(fieldName);
+			const Compiled::Field* const result = FindField(fieldName);
 
-			if(result == fields.end())
+			if(result == NULL)
 			{
-				Logger::Debug(boost::format("Field %1% not found") % fieldName);
+				LOGDEBUG(boost::format("Field %1% not found") % fieldName)
 				return;
 			}
 
-			std::stringstream(result->second) >> dest;
-		}
-		void GetField(const std::string& fieldName, Uint8& dest) const
-		{
-			unsigned short dummy;
-			GetField(fieldName, dummy);
-			dest = dummy;
-		}
-		void GetField(const std::string& fieldName, std::string& dest) const
-		{
-			const std::stringstream dummyStream;
-			std::streambuf* const dummy = dummyStream.rdbuf();
-			GetField(fieldName, dummy);
-			dest = dummyStream.str();
+			ParseValue(*result, dest);
 		}
+		void GetField(const std::string& fieldName, std::string& dest) const;
 	};
 
 private:
-	Config(ConfigScope);
-
-	static const Config gameConfig;
 	static std::string GetDefaultConfig();
 
 public:
-	// recurses into the right config scope via construction
+	// recurses into the right config scope (the _index_th one named _scopeName_) via construction
 	struct ConfigLoadable
 	{
-		ConfigLoadable(const std::string& scopeName, const ConfigScope*& in);
+		ConfigLoadable(const std::string& scopeName, const ConfigScope*& in, unsigned long index = 0);
 	};
 
 	template <typename _T>
@@ -120,11 +239,15 @@ public:
 
 		Collection list;
 
+		// _T is constructed from each of the _elementsName_ scopes, by index
 		LoadableCollection(const std::string& listName, const std::string& elementsName, const ConfigScope* in) :
 			ConfigLoadable(listName, in)
 		{
-			while(in->PeekScope(elementsName))
-				list.push_back(_T(in));
+			const unsigned long count = in->CountScopes(elementsName);
+			list.reserve(count);
+
+			for(unsigned long i = 0; i < count; ++i)
+				list.push_back(_T(in, i));
 		}
 			
 		iterator begin() { return list.begin(); }
@@ -195,7 +318,7 @@ public:
 		BoundsConfig bounds;
 		ColorConfig color;
 
-		WallConfig(const ConfigScope* in);
+		WallConfig(const ConfigScope* in, unsigned long index = 0);
 	};
 
 	struct ScreenConfig : public ConfigLoadable
@@ -206,6 +329,22 @@ public:
 		ScreenConfig(const ConfigScope* in);
 	};
 
+	// the size of the world, which can be bigger than the screen (see Graphics::Camera).
+	// Everything else in the world (walls, spawn bounds) is in world coordinates.
+	struct WorldConfig : public ConfigLoadable
+	{
+		unsigned long w, h;
+		// the size of the chunks the walls are split into, and how many bytes of chunks
+		// can be kept loaded (see Level and ChunkCache)
+		unsigned long chunkSize;
+		unsigned long chunkBudget;
+		// a level file to map the walls in from, instead of using _wallsConfig_ (optional)
+		std::string level;
+
+		// without a world scope, the world is the size of _screen_
+		WorldConfig(const ConfigScope* in, const ScreenConfig& screen);
+	};
+
 	struct SpawnCollectionConfig : public ConfigLoadable
 	{
 		struct SpawnConfig : public ConfigLoadable
@@ -220,10 +359,11 @@ public:
 			// spawn rate
 			double rate;
 
-			SpawnConfig(const std::string& spawnScope, const ConfigScope*& in);
+			SpawnConfig(const std::string& spawnScope, const ConfigScope*& in, unsigned long index);
 
-			// construct spawn from configuration data
-			virtual GameWorld::SpawnPtr ConstructSpawn(Point location) const = 0;
+			// add a spawn covering _bounds_ to _entities_, from configuration data
+			virtual void ConstructSpawn(EntityStore& entities, const Bounds& bounds,
+				Clock::TimeType expiryTime) const = 0;
 		};
 
 		struct FoodConfig : public SpawnConfig
@@ -232,16 +372,16 @@ public:
 			double lengthFactor;
 			short speedChange;
 
-			FoodConfig(const ConfigScope* in);
+			FoodConfig(const ConfigScope* in, unsigned long index = 0);
 
-			GameWorld::SpawnPtr ConstructSpawn(Point location) const;
+			void ConstructSpawn(EntityStore& entities, const Bounds& bounds, Clock::TimeType expiryTime) const;
 		};
 
 		struct MineConfig : public SpawnConfig
 		{
-			MineConfig(const ConfigScope* in);
+			MineConfig(const ConfigScope* in, unsigned long index = 0);
 
-			GameWorld::SpawnPtr ConstructSpawn(Point location) const;
+			void ConstructSpawn(EntityStore& entities, const Bounds& bounds, Clock::TimeType expiryTime) const;
 		};
 
 		typedef boost::shared_ptr<SpawnConfig> SpawnPtr;
@@ -251,6 +391,9 @@ public:
 		BoundsConfig bounds;
 		unsigned int period;
 		SpawnCollection spawnsConfig;
+		// picks what spawns each period: the index of one of _spawnsConfig_ (by its rate),
+		// or _spawnsConfig_.size() for nothing (with whatever odds the rates leave over)
+		AliasTable spawnTable;
 
 		SpawnCollectionConfig(const ConfigScope* in);
 	};
@@ -262,6 +405,7 @@ public:
 
 	LoadableCollection<WallConfig> wallsConfig;
 	ScreenConfig screen;
+	WorldConfig world;
 	SpawnCollectionConfig spawns;
 
 	unsigned int pointGainPeriod;
@@ -270,8 +414,12 @@ public:
 	SnakeConfig snake;
 	Resources resources;
 
-	// get the (only) configuration data
-	static const Config& Get();
+	// load the config from the root scope of a config file (see GetConfigLoader)
+	explicit Config(const ConfigScope& in);
 
+	// the path config_compiler writes _configFileName_'s compiled form to by default
+	static std::string GetCompiledFilename(const std::string& configFileName);
+	// load _configFileName_, preferring its compiled form if that's up to date,
+	// and falling back to the default config if it can't be opened
 	static const ConfigScope GetConfigLoader(const std::string& configFileName);
 };
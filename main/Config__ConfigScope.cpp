@@ -1,109 +1,578 @@
 #include "Config.hpp"
 #include "Logger.hpp"
 
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
 // TODO: more error-checking
 
-static std::string get(std::istream& in)
+static inline bool is_whitespace(const char c)
 {
-	std::string gotten;
-	char c = '\0';
-	do
-	{
-		if(in.eof())
-			return gotten;
+	return (c == ' ' || c == '\n' || c == '\t' || c == '\r');
+}
 
-		in.get(c);
-	}
-	while(c == ' ' || c == '\n' || c == '\t');
-	while(c != ' ' && c != '\n' && c != '\t')
+Config::ConfigScope::Token::Token() :
+	begin(NULL), length(0)
+{
+}
+
+Config::ConfigScope::Token::Token(const char* const _begin, const unsigned long _length) :
+	begin(_begin), length(_length)
+{
+}
+
+bool Config::ConfigScope::Token::operator==(const Token& token) const
+{
+	return (length == token.length && strncmp(begin, token.begin, length) == 0);
+}
+
+bool Config::ConfigScope::Token::operator==(const char* const str) const
+{
+	return (strncmp(begin, str, length) == 0 && str[length] == '\0');
+}
+
+bool Config::ConfigScope::Token::operator==(const std::string& str) const
+{
+	return (str.size() == length && str.compare(0, length, begin, length) == 0);
+}
+
+std::string Config::ConfigScope::Token::GetString() const
+{
+	return std::string(begin, length);
+}
+
+bool Config::ConfigScope::Token::ToUnsigned(unsigned long long& dest) const
+{
+	const char* c = begin;
+	const char* const end = begin + length;
+
+	if(c != end && *c == '+')
+		++c;
+	if(c == end)
+		return false;
+
+	const unsigned long long max = ~0ULL;
+	unsigned long long result = 0;
+	for(; c != end; ++c)
 	{
-		gotten += c;
-		
-		if(in.eof())
-			return gotten;
+		if(*c < '0' || *c > '9')
+			return false;
+
+		const unsigned int digit = *c - '0';
+		if(result > (max - digit) / 10)
+			return false;
 
-		in.get(c);
+		result = result * 10 + digit;
 	}
 
-	return gotten;
+	dest = result;
+	return true;
+}
+
+bool Config::ConfigScope::Token::ToInteger(long long& dest) const
+{
+	const bool negative = (length > 0 && *begin == '-');
+	const Token magnitudeToken = negative ? Token(begin + 1, length - 1) : *this;
+
+	unsigned long long magnitude;
+	if(!magnitudeToken.ToUnsigned(magnitude))
+		return false;
+
+	// the most negative value has no positive counterpart
+	const unsigned long long limit = negative ? 1ULL << 63 : (1ULL << 63) - 1;
+	if(magnitude > limit)
+		return false;
+
+	dest = negative ? static_cast<long long>(0 - magnitude) : static_cast<long long>(magnitude);
+	return true;
+}
+
+bool Config::ConfigScope::Token::ToDouble(double& dest) const
+{
+	// strtod needs a terminated string; copy to the stack rather than allocating
+	char buffer[64];
+	if(length == 0 || length >= sizeof(buffer))
+		return false;
+
+	memcpy(buffer, begin, length);
+	buffer[length] = '\0';
+
+	char* parseEnd;
+	errno = 0;
+	const double result = strtod(buffer, &parseEnd);
+	if(parseEnd != buffer + length || errno == ERANGE)
+		return false;
+
+	dest = result;
+	return true;
+}
+
+Config::ConfigScope::Tokenizer::Tokenizer(const char* const begin, const char* const _end) :
+	position(begin), end(_end)
+{
+}
+
+bool Config::ConfigScope::Tokenizer::Next(Token& token)
+{
+	while(position != end && is_whitespace(*position))
+		++position;
+
+	if(position == end)
+		return false;
+
+	const char* const begin = position;
+	while(position != end && !is_whitespace(*position))
+		++position;
+
+	token = Token(begin, position - begin);
+	return true;
+}
+
+class Config::ConfigScope::Tree : boost::noncopyable
+{
+private:
+	typedef Compiled::Index Index;
+
+	// backing storage for a tree parsed from text (the text itself is the string pool)
+	Compiled::Header headerStorage;
+	std::string text;
+	std::vector<Compiled::Field> fieldStorage;
+	std::vector<Compiled::Scope> scopeStorage;
+	std::vector<Compiled::Group> groupStorage;
+	std::vector<Index> childStorage;
+
+	// backing storage for a mapped compiled tree
+	boost::shared_ptr<boost::interprocess::mapped_region> region;
+
+	// A scope's records have to be contiguous, so while its subscopes are being parsed,
+	// they're kept on these stacks. Each scope's are popped off once it's finished.
+	typedef std::vector<std::pair<Token, Compiled::Field> > PendingFields;
+	typedef std::vector<std::pair<Token, Index> > PendingChildren;
+
+	PendingFields pendingFields;
+	PendingChildren pendingChildren;
+
+	Tree();
+
+	// parse the scope starting at _tokens_ (and all of its subscopes), returning its index
+	Index ParseScope(Tokenizer& tokens, long& bracketCount);
+	Compiled::String MakeString(const Token& token) const;
+
+	// point the record arrays at _data_, returning false if it isn't a valid compiled tree
+	bool Init(const char* data, unsigned long long size);
+	void InitViews();
+
+public:
+	const Compiled::Header* header;
+	const Compiled::Field* fields;
+	const Compiled::Scope* scopes;
+	const Compiled::Group* groups;
+	const Index* children;
+	const char* strings;
+
+	// every scope in the tree, in record order, for GetScope() to hand out
+	std::vector<ConfigScope> views;
+
+	Tree(std::string& text);
+
+	// map in a compiled tree, returning NULL if _filename_ isn't a valid one
+	static Tree* Map(const std::string& filename);
+
+	void Write(std::ostream& out) const;
+};
+
+Config::ConfigScope::Tree::Tree() :
+	header(NULL), fields(NULL), scopes(NULL), groups(NULL), children(NULL), strings(NULL)
+{
 }
 
-Config::ConfigScope::ConfigScope(std::istream& in, long& bracketCount)
+Config::ConfigScope::Tree::Tree(std::string& _text)
 {
-	Init(in, bracketCount);
+	text.swap(_text);
+
+	Tokenizer tokens(text.data(), text.data() + text.size());
+	long bracketCount = 0;
+	ParseScope(tokens, bracketCount);
+
+	if(bracketCount > 0)
+		LOGDEBUG("Warning: Scope underterminated (not enough \"}\")")
+	else if(bracketCount < 0)
+		LOGDEBUG("Warning: Scope overterminated (too many \"}\")")
+
+	headerStorage.magic = Compiled::magic;
+	headerStorage.version = Compiled::version;
+	headerStorage.fieldCount = fieldStorage.size();
+	headerStorage.scopeCount = scopeStorage.size();
+	headerStorage.groupCount = groupStorage.size();
+	headerStorage.childCount = childStorage.size();
+	headerStorage.stringsSize = text.size();
+	headerStorage.padding = 0;
+
+	header = &headerStorage;
+	fields = fieldStorage.empty() ? NULL : &fieldStorage[0];
+	scopes = &scopeStorage[0];
+	groups = groupStorage.empty() ? NULL : &groupStorage[0];
+	children = childStorage.empty() ? NULL : &childStorage[0];
+	strings = text.data();
+
+	InitViews();
 }
 
-void Config::ConfigScope::Init(std::istream& in, long& bracketCount)
+Config::ConfigScope::Compiled::String Config::ConfigScope::Tree::MakeString(const Token& token) const
 {
-	while(!in.eof())
+	Compiled::String string;
+	string.offset = token.begin - text.data();
+	string.length = token.length;
+
+	return string;
+}
+
+Config::ConfigScope::Compiled::Index Config::ConfigScope::Tree::ParseScope(Tokenizer& tokens, long& bracketCount)
+{
+	const unsigned long firstPendingField = pendingFields.size();
+	const unsigned long firstPendingChild = pendingChildren.size();
+
+	const Index scopeIndex = scopeStorage.size();
+	scopeStorage.push_back(Compiled::Scope());
+
+	Token name;
+	while(tokens.Next(name))
 	{
-		const std::string name = get(in);
-		
 		// start of scope
 		if(name == "{")
 		{
 			++bracketCount;
-			EnterScope(in, bracketCount);
+
+			Token scopeType;
+			if(!tokens.Next(scopeType))
+			{
+				LOGDEBUG("Warning: Scope opened at the end of the config, without a name")
+				break;
+			}
+
+			const Index child = ParseScope(tokens, bracketCount);
+			pendingChildren.push_back(std::make_pair(scopeType, child));
 		}
 		// end of scope
 		else if(name == "}")
 		{
 			--bracketCount;
-			return;
+			break;
 		}
 		else
 		{
-			const std::string value = get(in);
-			
-			if(fields.find(name) != fields.end())
-				Logger::Debug(boost::format("Warning: field \"%1%\" already exists") % name);
+			Token value;
+			if(!tokens.Next(value))
+			{
+				LOGDEBUG(boost::format("Warning: field \"%1%\" has no value") % name.GetString())
+				break;
+			}
+
+			Compiled::Field field;
+			field.name = MakeString(name);
+			field.value = MakeString(value);
+			field.integer = 0;
+			field.unsignedInteger = 0;
+			field.real = 0;
+			field.flags = 0;
+			field.padding = 0;
+
+			long long integer;
+			unsigned long long unsignedInteger;
+			if(value.ToInteger(integer))
+			{
+				field.integer = integer;
+				field.flags |= Compiled::Field::hasInteger;
+			}
+			if(value.ToUnsigned(unsignedInteger))
+			{
+				field.unsignedInteger = unsignedInteger;
+				field.flags |= Compiled::Field::hasUnsigned;
+			}
+
+			// integers convert to doubles exactly as strtod would, without reparsing
+			if(field.flags & Compiled::Field::hasInteger)
+				field.real = static_cast<double>(field.integer);
+			else if(field.flags & Compiled::Field::hasUnsigned)
+				field.real = static_cast<double>(field.unsignedInteger);
+
+			if(field.flags != 0 || value.ToDouble(field.real))
+				field.flags |= Compiled::Field::hasReal;
 
-			fields[name] = value;
+			PendingFields::iterator existing = pendingFields.begin() + firstPendingField;
+			while(existing != pendingFields.end() && !(existing->first == name))
+				++existing;
+
+			if(existing != pendingFields.end())
+			{
+				LOGDEBUG(boost::format("Warning: field \"%1%\" already exists") % name.GetString())
+				existing->second = field;
+			}
+			else
+				pendingFields.push_back(std::make_pair(name, field));
 		}
 	}
+
+	Compiled::Scope& scope = scopeStorage[scopeIndex];
+	scope.firstField = fieldStorage.size();
+	scope.fieldCount = pendingFields.size() - firstPendingField;
+	scope.firstGroup = groupStorage.size();
+
+	for(unsigned long i = firstPendingField; i < pendingFields.size(); ++i)
+		fieldStorage.push_back(pendingFields[i].second);
+
+	// group the children by name, in order of each name's first appearance
+	for(unsigned long i = firstPendingChild; i < pendingChildren.size(); ++i)
+	{
+		const Token& groupName = pendingChildren[i].first;
+
+		bool grouped = false;
+		for(Index group = scope.firstGroup; group < groupStorage.size() && !grouped; ++group)
+			grouped = (Token(text.data() + groupStorage[group].name.offset, groupStorage[group].name.length) == groupName);
+
+		if(grouped)
+			continue;
+
+		Compiled::Group group;
+		group.name = MakeString(groupName);
+		group.firstChild = childStorage.size();
+
+		for(unsigned long j = i; j < pendingChildren.size(); ++j)
+			if(pendingChildren[j].first == groupName)
+				childStorage.push_back(pendingChildren[j].second);
+
+		group.childCount = childStorage.size() - group.firstChild;
+		groupStorage.push_back(group);
+	}
+
+	scope.groupCount = groupStorage.size() - scope.firstGroup;
+
+	pendingFields.resize(firstPendingField);
+	pendingChildren.resize(firstPendingChild);
+
+	return scopeIndex;
 }
 
-void Config::ConfigScope::EnterScope(std::istream& in, long& bracketCount)
+static inline bool is_valid_string(const Config::ConfigScope::Compiled::String& string,
+	const Config::ConfigScope::Compiled::Header& header)
 {
-	const std::string scopeType = get(in);
-	ScopeCollection& scopeCollection = subscopes[scopeType];
-	// allocate a new subscope with this name
-	scopeCollection.Add(ConfigScope(in, bracketCount));
+	return (string.offset <= header.stringsSize && string.length <= header.stringsSize - string.offset);
 }
 
-Config::ConfigScope::ConfigScope(std::istream& in)
+static inline bool is_valid_range(const Config::ConfigScope::Compiled::Index first,
+	const Config::ConfigScope::Compiled::Index count, const Config::ConfigScope::Compiled::Index size)
 {
-	long bracketCount = 0;
-	Init(in, bracketCount);
-
-	if(bracketCount > 0)
-		Logger::Debug("Warning: Scope underterminated (not enough \"}\")");
-	else if(bracketCount < 0)
-		Logger::Debug("Warning: Scope overterminated (too many \"}\")");
+	return (first <= size && count <= size - first);
 }
 
-bool Config::ConfigScope::PeekScope(const std::string& name) const
+bool Config::ConfigScope::Tree::Init(const char* const data, const unsigned long long size)
 {
-	const ScopeMap::const_iterator index = subscopes.find(name);
+	if(size < sizeof(Compiled::Header))
+		return false;
+
+	header = reinterpret_cast<const Compiled::Header*>(data);
+	if(header->magic != Compiled::magic || header->version != Compiled::version || header->scopeCount == 0)
+		return false;
 
-	if(index == subscopes.end())
+	const unsigned long long expectedSize = sizeof(Compiled::Header)
+		+ static_cast<unsigned long long>(header->fieldCount) * sizeof(Compiled::Field)
+		+ static_cast<unsigned long long>(header->scopeCount) * sizeof(Compiled::Scope)
+		+ static_cast<unsigned long long>(header->groupCount) * sizeof(Compiled::Group)
+		+ static_cast<unsigned long long>(header->childCount) * sizeof(Index)
+		+ header->stringsSize;
+	if(size != expectedSize)
 		return false;
 
-	const ScopeCollection& scopeCollection = index->second;
+	fields = reinterpret_cast<const Compiled::Field*>(header + 1);
+	scopes = reinterpret_cast<const Compiled::Scope*>(fields + header->fieldCount);
+	groups = reinterpret_cast<const Compiled::Group*>(scopes + header->scopeCount);
+	children = reinterpret_cast<const Index*>(groups + header->groupCount);
+	strings = reinterpret_cast<const char*>(children + header->childCount);
+
+	// check every reference once here, so that they can be followed blindly afterwards
+	for(Index i = 0; i < header->fieldCount; ++i)
+		if(!is_valid_string(fields[i].name, *header) || !is_valid_string(fields[i].value, *header))
+			return false;
+
+	for(Index i = 0; i < header->scopeCount; ++i)
+		if(!is_valid_range(scopes[i].firstField, scopes[i].fieldCount, header->fieldCount)
+			|| !is_valid_range(scopes[i].firstGroup, scopes[i].groupCount, header->groupCount))
+			return false;
 
-	return scopeCollection.HasNextScope();
+	for(Index i = 0; i < header->groupCount; ++i)
+		if(!is_valid_string(groups[i].name, *header)
+			|| !is_valid_range(groups[i].firstChild, groups[i].childCount, header->childCount))
+			return false;
+
+	for(Index i = 0; i < header->childCount; ++i)
+		if(children[i] >= header->scopeCount)
+			return false;
+
+	InitViews();
+	return true;
+}
+
+void Config::ConfigScope::Tree::InitViews()
+{
+	views.reserve(header->scopeCount);
+	for(Index i = 0; i < header->scopeCount; ++i)
+		views.push_back(ConfigScope(this, i));
 }
 
-const Config::ConfigScope* Config::ConfigScope::GetScope(const std::string& name) const
+Config::ConfigScope::Tree* Config::ConfigScope::Tree::Map(const std::string& filename)
 {
-	if(!PeekScope(name))
+	std::auto_ptr<Tree> tree(new Tree());
+
+	try
+	{
+		const boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+		tree->region.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+	}
+	catch(const boost::interprocess::interprocess_exception& e)
+	{
+		LOGDEBUG(boost::format("Unable to map compiled config \"%1%\": %2%") % filename % e.what())
+		return NULL;
+	}
+
+	if(!tree->Init(static_cast<const char*>(tree->region->get_address()), tree->region->get_size()))
 	{
-		Logger::Debug(boost::format("Scope %1% not found to enter") % name);
+		LOGDEBUG(boost::format("\"%1%\" is not a valid compiled config (version %2%)") % filename
+			% static_cast<unsigned int>(Compiled::version))
 		return NULL;
 	}
 
-	const ScopeMap::const_iterator index = subscopes.find(name);
-	const ScopeCollection& scopeCollection = index->second;
+	return tree.release();
+}
+
+void Config::ConfigScope::Tree::Write(std::ostream& out) const
+{
+	out.write(reinterpret_cast<const char*>(header), sizeof(*header));
+	out.write(reinterpret_cast<const char*>(fields), header->fieldCount * sizeof(*fields));
+	out.write(reinterpret_cast<const char*>(scopes), header->scopeCount * sizeof(*scopes));
+	out.write(reinterpret_cast<const char*>(groups), header->groupCount * sizeof(*groups));
+	out.write(reinterpret_cast<const char*>(children), header->childCount * sizeof(*children));
+	out.write(strings, header->stringsSize);
+}
+
+Config::ConfigScope::ConfigScope(const Tree* const _tree, const Compiled::Index _index) :
+	tree(_tree), index(_index)
+{
+}
+
+Config::ConfigScope::ConfigScope(const boost::shared_ptr<const Tree>& _tree) :
+	owner(_tree), tree(_tree.get()), index(0)
+{
+}
+
+static std::string read_all(std::istream& in)
+{
+	return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+Config::ConfigScope::ConfigScope(std::istream& in) :
+	index(0)
+{
+	// read the whole input at once, and tokenize it in place
+	std::string text(read_all(in));
+	owner.reset(new Tree(text));
+	tree = owner.get();
+}
+
+Config::ConfigScope::ConfigScope(const std::string& configText) :
+	index(0)
+{
+	std::string text(configText);
+	owner.reset(new Tree(text));
+	tree = owner.get();
+}
+
+std::auto_ptr<Config::ConfigScope> Config::ConfigScope::LoadCompiled(const std::string& filename)
+{
+	const boost::shared_ptr<const Tree> tree(Tree::Map(filename));
+	if(tree.get() == NULL)
+		return std::auto_ptr<ConfigScope>();
+
+	return std::auto_ptr<ConfigScope>(new ConfigScope(tree));
+}
+
+void Config::ConfigScope::WriteCompiled(std::ostream& out) const
+{
+	tree->Write(out);
+}
+
+std::string Config::ConfigScope::GetString(const Compiled::String& string) const
+{
+	return std::string(tree->strings + string.offset, string.length);
+}
+
+static inline bool string_equals(const char* const strings, const Config::ConfigScope::Compiled::String& string,
+	const std::string& str)
+{
+	return (str.size() == string.length && str.compare(0, string.length, strings + string.offset, string.length) == 0);
+}
+
+const Config::ConfigScope::Compiled::Field* Config::ConfigScope::FindField(const std::string& name) const
+{
+	const Compiled::Scope& scope = tree->scopes[index];
+	for(const Compiled::Field* i = tree->fields + scope.firstField, * end = i + scope.fieldCount; i != end; ++i)
+		if(string_equals(tree->strings, i->name, name))
+			return i;
+
+	return NULL;
+}
+
+const Config::ConfigScope::Compiled::Group* Config::ConfigScope::FindGroup(const std::string& name) const
+{
+	const Compiled::Scope& scope = tree->scopes[index];
+	for(const Compiled::Group* i = tree->groups + scope.firstGroup, * end = i + scope.groupCount; i != end; ++i)
+		if(string_equals(tree->strings, i->name, name))
+			return i;
+
+	return NULL;
+}
+
+void Config::ConfigScope::GetField(const std::string& fieldName, std::string& dest) const
+{
+	const Compiled::Field* const result = FindField(fieldName);
+
+	if(result == NULL)
+	{
+		LOGDEBUG(boost::format("Field %1% not found") % fieldName)
+		return;
+	}
+
+	dest = GetString(result->value);
+}
+
+unsigned long Config::ConfigScope::CountScopes(const std::string& name) const
+{
+	const Compiled::Group* const group = FindGroup(name);
+
+	return (group == NULL) ? 0 : group->childCount;
+}
+
+const Config::ConfigScope* Config::ConfigScope::GetScope(const std::string& name, const unsigned long index) const
+{
+	const Compiled::Group* const group = FindGroup(name);
+
+	if(group == NULL || index >= group->childCount)
+	{
+		LOGDEBUG(boost::format("Scope %1% #%2% not found to enter") % name % index)
+		return NULL;
+	}
 
-	return &scopeCollection.GetNextScope();
+	return &tree->views[tree->children[group->firstChild + index]];
 }
@@ -1,15 +1,16 @@
 #include "Config.hpp"
 
-#include "Food.hpp"
-#include "Mine.hpp"
+#include "EntityStore.hpp"
 
-GameWorld::SpawnPtr Config::SpawnCollectionConfig::FoodConfig::ConstructSpawn(const Point location) const
+void Config::SpawnCollectionConfig::FoodConfig::ConstructSpawn(EntityStore& entities, const Bounds& bounds,
+	const Clock::TimeType expiryTime) const
 {
-	return GameWorld::SpawnPtr(new Food(location, size + cushion, color,
-		points, lengthFactor, speedChange));
+	entities.Create(WorldObject::food, bounds, color, expiryTime,
+		EntityStore::FoodEffects(points, lengthFactor, speedChange));
 }
 
-GameWorld::SpawnPtr Config::SpawnCollectionConfig::MineConfig::ConstructSpawn(const Point location) const
+void Config::SpawnCollectionConfig::MineConfig::ConstructSpawn(EntityStore& entities, const Bounds& bounds,
+	const Clock::TimeType expiryTime) const
 {
-	return GameWorld::SpawnPtr(new Mine(location, size + cushion, color));
+	entities.Create(WorldObject::mine, bounds, color, expiryTime);
 }
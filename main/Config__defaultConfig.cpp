@@ -13,6 +13,11 @@ FPS 60\n\
 	{ color r 0 g 0 b 0 }\n\
 }\n\
 \n\
+{ world\n\
+	w 800\n\
+	h 600\n\
+}\n\
+\n\
 { resources\n\
 	eat resources/eat.wav\n\
 	spawn resources/spawn.wav\n\
@@ -6,26 +6,41 @@
 #pragma warning(push, 0)
 #endif
 
+#include <boost/static_assert.hpp>
 #include <SDL_types.h>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-// must be either a cardinal direction, or have no length
-// can only be copy-constructed from existing directions
-// (see static const members), or default-constructed to be empty
+// must be either a cardinal direction, or have no length. Stored as one of _Value_, where bit 0
+// is set for the directions along an axis (right and down), and bit 1 for the vertical ones.
 class Direction
 {
+public:
+	enum Value
+	{
+		left = 0,
+		right = 1,
+		up = 2,
+		down = 3,
+		empty = 4
+	};
+
+	enum Bits
+	{
+		positiveBit = 1,
+		verticalBit = 2
+	};
+
 private:
-	Direction(Sint8 x, Sint8 y);
-	Vector2D direction;
+	Uint8 value;
 
 public:
 	Direction();
+	Direction(Value value);
 
-	static const Direction empty, left, right, up, down;
-
+	Value GetValue() const;
 	operator Vector2D() const;
 
 	// return the opposite direction
@@ -34,4 +49,57 @@ public:
 	bool operator==(Direction) const;
 
 	bool IsHorizontal() const;
+
+	// read or write this direction through _archive_ (see GameWorld::SaveSnapshot)
+	template <typename Archive>
+	void Serialize(Archive& archive)
+	{
+		archive & value;
+	}
 };
+
+// opposites differ only in _positiveBit_
+BOOST_STATIC_ASSERT((Direction::left ^ Direction::positiveBit) == Direction::right);
+BOOST_STATIC_ASSERT((Direction::up ^ Direction::positiveBit) == Direction::down);
+BOOST_STATIC_ASSERT(!(Direction::left & Direction::verticalBit) && !(Direction::right & Direction::verticalBit));
+BOOST_STATIC_ASSERT((Direction::up & Direction::verticalBit) && (Direction::down & Direction::verticalBit));
+BOOST_STATIC_ASSERT(sizeof(Direction) == 1);
+
+inline Direction::Direction() :
+	value(empty)
+{
+}
+
+inline Direction::Direction(const Value _value) :
+	value(_value)
+{
+}
+
+inline Direction::Value Direction::GetValue() const
+{
+	return static_cast<Value>(value);
+}
+
+inline Direction::operator Vector2D() const
+{
+	static const Sint8 xs[] = {-1, 1, 0, 0, 0};
+	static const Sint8 ys[] = {0, 0, -1, 1, 0};
+
+	return Vector2D(xs[value], ys[value]);
+}
+
+inline Direction Direction::operator-() const
+{
+	// flip _positiveBit_, unless this is _empty_
+	return static_cast<Value>(value ^ ((value >> 2) ^ 1));
+}
+
+inline bool Direction::operator==(const Direction obj) const
+{
+	return (value == obj.value);
+}
+
+inline bool Direction::IsHorizontal() const
+{
+	return (value < up);
+}
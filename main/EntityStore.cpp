@@ -0,0 +1,143 @@
+#include "EntityStore.hpp"
+
+#include "Logger.hpp"
+
+EntityStore::FoodEffects::FoodEffects() :
+	pointChange(0), lengthFactor(0), speedChange(0)
+{
+}
+
+EntityStore::FoodEffects::FoodEffects(const long long _pointChange, const double _lengthFactor,
+	const short _speedChange) :
+	pointChange(_pointChange), lengthFactor(_lengthFactor), speedChange(_speedChange)
+{
+}
+
+EntityStore::ID EntityStore::Create(const WorldObject::ObjectType type, const Bounds& entityBounds,
+	const Color24 color, const Clock::TimeType expiryTime, const FoodEffects& entityEffects)
+{
+	ID id;
+	if(freeSlots.empty())
+	{
+		id.slot = slots.size();
+		id.generation = 0;
+		slots.push_back(Slot());
+	}
+	else
+	{
+		id.slot = freeSlots.back();
+		id.generation = slots[id.slot].generation;
+		freeSlots.pop_back();
+	}
+
+	Slot& slot = slots[id.slot];
+	slot.generation = id.generation;
+	slot.index = GetCount();
+
+	bounds.push_back(entityBounds);
+	colors.push_back(Palette::GetIndex(color));
+	types.push_back(type);
+	effects.push_back(entityEffects);
+	expiryTimes.push_back(expiryTime);
+	entitySlots.push_back(id.slot);
+
+	return id;
+}
+
+void EntityStore::Destroy(const ID id)
+{
+	if(!IsLive(id))
+	{
+		LOGDEBUG("Destroying an entity which isn't live")
+		return;
+	}
+
+	Slot& slot = slots[id.slot];
+	const Index index = slot.index;
+	const Index last = GetCount() - 1;
+
+	// fill the gap with the last entity, so that the arrays stay dense
+	bounds[index] = bounds[last];
+	colors[index] = colors[last];
+	types[index] = types[last];
+	effects[index] = effects[last];
+	expiryTimes[index] = expiryTimes[last];
+	entitySlots[index] = entitySlots[last];
+	slots[entitySlots[index]].index = index;
+
+	bounds.pop_back();
+	colors.pop_back();
+	types.pop_back();
+	effects.pop_back();
+	expiryTimes.pop_back();
+	entitySlots.pop_back();
+
+	// any IDs still referring to this slot are no longer live
+	++slot.generation;
+	freeSlots.push_back(id.slot);
+}
+
+void EntityStore::Clear()
+{
+	for(std::vector<boost::uint32_t>::const_iterator i = entitySlots.begin(), end = entitySlots.end(); i != end; ++i)
+	{
+		++slots[*i].generation;
+		freeSlots.push_back(*i);
+	}
+
+	bounds.clear();
+	colors.clear();
+	types.clear();
+	effects.clear();
+	expiryTimes.clear();
+	entitySlots.clear();
+}
+
+bool EntityStore::IsLive(const ID id) const
+{
+	return id.slot < slots.size() && slots[id.slot].generation == id.generation;
+}
+
+EntityStore::Index EntityStore::GetIndex(const ID id) const
+{
+	return slots[id.slot].index;
+}
+
+EntityStore::ID EntityStore::GetID(const Index index) const
+{
+	ID id;
+	id.slot = entitySlots[index];
+	id.generation = slots[id.slot].generation;
+
+	return id;
+}
+
+EntityStore::Index EntityStore::GetCount() const
+{
+	return bounds.size();
+}
+
+const EntityStore::BoundsArray& EntityStore::GetBounds() const
+{
+	return bounds;
+}
+
+const EntityStore::ColorArray& EntityStore::GetColors() const
+{
+	return colors;
+}
+
+const EntityStore::TypeArray& EntityStore::GetTypes() const
+{
+	return types;
+}
+
+const EntityStore::FoodEffectsArray& EntityStore::GetFoodEffects() const
+{
+	return effects;
+}
+
+const EntityStore::TimeArray& EntityStore::GetExpiryTimes() const
+{
+	return expiryTimes;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Bounds.hpp"
+#include "Clock.hpp"
+#include "Color24.hpp"
+#include "Palette.hpp"
+#include "WorldObject.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <SDL_types.h>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// The spawned objects (food and mines), stored as one array per component instead of one object
+// per spawn, so that anything which only needs some of the components (e.g. physics only needs
+// the bounds) runs through just those, in order. Entities are referred to by IDs, which stop being
+// live (rather than referring to some other entity) once their entity is destroyed.
+// Like world objects, this is only changed by its world's thread, with the graphics collection's
+// lock held.
+class EntityStore
+{
+public:
+	struct ID
+	{
+		// the slot the entity is in, and how many entities have been in that slot before it
+		boost::uint32_t slot;
+		boost::uint32_t generation;
+	};
+
+	// what eating a food does to the snake
+	struct FoodEffects
+	{
+		long long pointChange;
+		double lengthFactor;
+		short speedChange;
+
+		FoodEffects();
+		FoodEffects(long long pointChange, double lengthFactor, short speedChange);
+	};
+
+	// a position in the component arrays. Destroying an entity moves the last one into its place.
+	typedef boost::uint32_t Index;
+
+	typedef std::vector<Bounds> BoundsArray;
+	typedef std::vector<Palette::Index> ColorArray;
+	// WorldObject::ObjectTypes, in a byte each
+	typedef std::vector<Uint8> TypeArray;
+	typedef std::vector<FoodEffects> FoodEffectsArray;
+	typedef std::vector<Clock::TimeType> TimeArray;
+
+private:
+	struct Slot
+	{
+		boost::uint32_t generation;
+		// where this slot's entity is in the component arrays
+		Index index;
+	};
+
+	// the components, all in the same order
+	BoundsArray bounds;
+	ColorArray colors;
+	TypeArray types;
+	// anything but food has the default (no) effects
+	FoodEffectsArray effects;
+	TimeArray expiryTimes;
+	// the slot each entity is in
+	std::vector<boost::uint32_t> entitySlots;
+
+	std::vector<Slot> slots;
+	// slots with no entity in them
+	std::vector<boost::uint32_t> freeSlots;
+
+public:
+	// add an entity at the end of the component arrays, and return its ID
+	ID Create(WorldObject::ObjectType type, const Bounds& bounds, Color24 color, Clock::TimeType expiryTime,
+		const FoodEffects& effects = FoodEffects());
+	// destroy _id_'s entity, if it's still live
+	void Destroy(ID id);
+	void Clear();
+
+	bool IsLive(ID id) const;
+	// the position of _id_'s (live) entity in the component arrays
+	Index GetIndex(ID id) const;
+	// the ID of the entity at _index_
+	ID GetID(Index index) const;
+	Index GetCount() const;
+
+	// the component arrays, each GetCount() long
+	const BoundsArray& GetBounds() const;
+	const ColorArray& GetColors() const;
+	const TypeArray& GetTypes() const;
+	const FoodEffectsArray& GetFoodEffects() const;
+	const TimeArray& GetExpiryTimes() const;
+
+	// read or write every entity, in order, through _archive_ (see GameWorld::SaveSnapshot).
+	// Entities are stored by their components, so loading gives them new IDs.
+	template <typename Archive>
+	void Serialize(Archive& archive)
+	{
+		boost::uint32_t count = GetCount();
+		archive & count;
+
+		if(Archive::is_loading::value)
+			Clear();
+
+		for(Index i = 0; i < count; ++i)
+		{
+			Uint8 type = 0;
+			Color24 color;
+			Bounds entityBounds;
+			Clock::TimeType expiryTime = 0;
+			FoodEffects entityEffects;
+
+			if(!Archive::is_loading::value)
+			{
+				type = types[i];
+				// palette indices depend on the order colors were first used in, so the color itself is stored
+				color = Palette::GetColor(colors[i]);
+				entityBounds = bounds[i];
+				expiryTime = expiryTimes[i];
+				entityEffects = effects[i];
+			}
+
+			archive & type & color.r & color.g & color.b;
+			archive & entityBounds.min.x & entityBounds.min.y & entityBounds.max.x & entityBounds.max.y;
+			archive & expiryTime;
+			archive & entityEffects.pointChange & entityEffects.lengthFactor & entityEffects.speedChange;
+
+			if(Archive::is_loading::value)
+				Create(static_cast<WorldObject::ObjectType>(type), entityBounds, color, expiryTime, entityEffects);
+		}
+	}
+};
@@ -1,5 +1,7 @@
 #include "EventHandler.hpp"
 
+#include "Profiler.hpp"
+
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
@@ -13,19 +15,19 @@
 RecursiveMutex EventHandler::mutex;
 static const EventHandler* eventHandler;
 
-EventHandler::EventHandler(QuitCallbackType onquit, LossCallbackType onloss, PauseCallbackType onpause,
-	SoundCallbackType onsound, KeyCallbackType onkey, MouseCallbackType onmouse)
+EventHandler::EventHandler(QuitCallbackType onquit, PauseCallbackType onpause, KeyCallbackType onkey,
+	MouseCallbackType onmouse)
 {
 	QuitCallback = onquit;
-	LossCallback = onloss;
 	PauseCallback = onpause;
-	SoundCallback = onsound;
 	KeyCallback = onkey;
 	MouseCallback = onmouse;
 }
 
 void EventHandler::HandleEventQueue() const
 {
+	PROFILESCOPE(eventPump)
+
 	SDL_Event event;
 
 	while(SDL_PollEvent(&event))
@@ -20,9 +20,7 @@ struct ZippedUniqueObjectCollection;
 struct EventHandler
 {
 	typedef void (QuitCallbackType)();
-	typedef void (LossCallbackType)();
 	typedef void (PauseCallbackType)();
-	typedef void (SoundCallbackType)(const std::string& filename);
 	typedef void (KeyCallbackType)(SDLKey keyPressed);
 	typedef void (MouseCallbackType)(Uint8 mouseButton);
 
@@ -32,16 +30,13 @@ struct EventHandler
 	type##CallbackType* type##Callback;
 
 	DECLARE_CALLBACK_FUNCTOR(Quit)
-	DECLARE_CALLBACK_FUNCTOR(Loss)
 	DECLARE_CALLBACK_FUNCTOR(Pause)
-	DECLARE_CALLBACK_FUNCTOR(Sound)
 	DECLARE_CALLBACK_FUNCTOR(Key)
 	DECLARE_CALLBACK_FUNCTOR(Mouse)
 
 #undef DECLARE_CALLBACK_FUNCTOR
 
-	EventHandler(QuitCallbackType, LossCallbackType, PauseCallbackType, SoundCallbackType, KeyCallbackType,
-		MouseCallbackType);
+	EventHandler(QuitCallbackType, PauseCallbackType, KeyCallbackType, MouseCallbackType);
 
 	// get and handle the queue of events from SDL
 	void HandleEventQueue() const;
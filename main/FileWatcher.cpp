@@ -0,0 +1,108 @@
+#include "FileWatcher.hpp"
+
+#include "Logger.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <SDL_timer.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+static const unsigned int checkPeriod = 250;
+
+static std::time_t get_write_time(const std::string& filename)
+{
+	boost::system::error_code error;
+	const std::time_t writeTime = boost::filesystem::last_write_time(filename, error);
+
+	return error ? 0 : writeTime;
+}
+
+FileWatcher::FileWatcher(const std::string& _filename) :
+	filename(_filename), lastCheck(SDL_GetTicks()), inotifyFd(-1), lastWriteTime(get_write_time(filename))
+{
+#ifdef __linux__
+	std::string directory = boost::filesystem::path(filename).parent_path().string();
+	if(directory.empty())
+		directory = ".";
+
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(inotifyFd >= 0 && inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		close(inotifyFd);
+		inotifyFd = -1;
+	}
+
+	if(inotifyFd < 0)
+		LOGDEBUG(boost::format("Unable to watch \"%1%\" with inotify; polling it instead") % filename)
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if(inotifyFd >= 0)
+		close(inotifyFd);
+#endif
+}
+
+bool FileWatcher::PollWriteTime()
+{
+	const std::time_t writeTime = get_write_time(filename);
+	if(writeTime == lastWriteTime)
+		return false;
+
+	lastWriteTime = writeTime;
+	return true;
+}
+
+bool FileWatcher::ReadEvents()
+{
+	bool changed = false;
+
+#ifdef __linux__
+	const std::string name = boost::filesystem::path(filename).filename().string();
+
+	// drain every pending event, since several usually arrive per save
+	char buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
+	ssize_t length;
+	while((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+	{
+		for(const char* i = buffer; i < buffer + length; )
+		{
+			const inotify_event* const event = reinterpret_cast<const inotify_event*>(i);
+			if(event->len > 0 && name == event->name)
+				changed = true;
+
+			i += sizeof(inotify_event) + event->len;
+		}
+	}
+#endif
+
+	return changed;
+}
+
+bool FileWatcher::HasChanged()
+{
+	const unsigned int now = SDL_GetTicks();
+	if(now - lastCheck < checkPeriod)
+		return false;
+
+	lastCheck = now;
+
+	if(inotifyFd >= 0)
+		return ReadEvents();
+
+	return PollWriteTime();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/noncopyable.hpp>
+#include <ctime>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// notices changes to a file, without blocking. On Linux this uses inotify on the file's directory
+// (so that editors which replace the file are noticed too); elsewhere, it polls the file's write time.
+class FileWatcher : private boost::noncopyable
+{
+private:
+	std::string filename;
+	// only check every _checkPeriod_ ms, since HasChanged() is called from busy loops
+	unsigned int lastCheck;
+
+	// the inotify instance, or -1 if it couldn't be set up (and polling is used instead)
+	int inotifyFd;
+	// the last-seen write time, when polling
+	std::time_t lastWriteTime;
+
+	bool PollWriteTime();
+	bool ReadEvents();
+
+public:
+	FileWatcher(const std::string& filename);
+	~FileWatcher();
+
+	// return true iff the file has been (re)written since the last call
+	bool HasChanged();
+};
@@ -1,219 +1,231 @@
 #include "GameWorld.hpp"
 
+#include "Camera.hpp"
 #include "Common.hpp"
 #include "Config.hpp"
 #include "custom_algorithm.hpp"
-#include "EventHandler.hpp"
-#include "Food.hpp"
+#include "EntityStore.hpp"
+#include "InputRecorder.hpp"
 #include "Logger.hpp"
-#include "Mine.hpp"
 #include "Physics.hpp"
-#include "Wall.hpp"
+#include "Profiler.hpp"
+#include "Snapshot.hpp"
 #include "ZippedUniqueObjectCollection.hpp"
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
-#include <boost/bind.hpp>
-#include <boost/random.hpp>
-#include <boost/thread.hpp>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <cstdlib>
 #include <functional>
-#include <SDL_timer.h>
+#include <limits>
 #include <SDL_mixer.h>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-static void make_new_wall(GameWorld::WallCollection& walls, const Config::WallConfig& wallConfig)
+// the level to play with _config_: its level file if it has one (and it can be mapped), or else its walls
+static Level* make_level(const Config& config)
 {
-	walls.push_back(Wall(wallConfig.bounds, wallConfig.color));
-}
+	if(!config.world.level.empty())
+	{
+		Level* const level = Level::Map(config.world.level);
+		if(level != NULL)
+			return level;
 
-static inline void make_walls(GameWorld::WallCollection& walls)
-{
-	for_each(Config::Get().wallsConfig.begin(), Config::Get().wallsConfig.end(),
-		boost::bind(&make_new_wall, boost::ref(walls), _1));
-}
+		LOGDEBUG(boost::format("Couldn't load level \"%1%\"; using the walls in the config") % config.world.level)
+	}
 
-static inline void play_sound(const std::string& filename)
-{
-	EventHandler::Get()->SoundCallback(filename);
+	return new Level(config);
 }
 
-static inline void play_spawn_sound()
+// The chunks that have to be loaded with the snake's head at _head_: everything the camera can see, and
+// a chunk more around it, so chunks are loaded before they come into view, and the head (which is always
+// in view) never gets near an unloaded chunk.
+static Bounds get_needed_region(const Config& config, const Bounds& head, const unsigned long chunkSize)
 {
-	play_sound(Config::Get().resources.spawn);
+	Graphics::Camera camera(Point(config.screen.w, config.screen.h));
+	camera.Follow(head, Point(config.world.w, config.world.h));
+
+	const Point::Coordinate margin = chunkSize;
+	Bounds region = camera.GetView();
+	region.min.x -= margin;
+	region.min.y -= margin;
+	region.max.x += margin;
+	region.max.y += margin;
+	return region;
 }
 
-static inline void play_death_sound()
+// the bounds of a new spawn (including its cushion) somewhere random in the spawn area
+static Bounds get_new_spawn_bounds(const Config::SpawnCollectionConfig::SpawnConfig& spawnConfig,
+	const Config& config, Random& random)
 {
-	play_sound(Config::Get().resources.die);
-}
+	const Bounds& spawnBounds = config.spawns.bounds;
+	const unsigned short size = spawnConfig.size + spawnConfig.cushion;
 
-static inline void play_eat_sound()
-{
-	play_sound(Config::Get().resources.eat);
-}
+	// get random number between the worldBounds
+#define GETSIZEDRANDOM(m) (random() % ( \
+	(spawnBounds.max.m - spawnBounds.min.m) - size + 1) + spawnBounds.min.m)
 
-// checks if _probability_ occurred in _randnum_ probability-checking can be done by seeing if
-// _randnum_ <= _probability_ * _max_number_. However, this means if we check for 1/6, and then check for
-// 1/3, since (_max_)(1/6) is encompassed in (_max_)(1/3), this can lead to unexpected results. Therefore,
-// the region used in calculation is subtracted from _randnum_, so that it may be called again without
-// having to account for these side-effects. (if the probability was hit, we can assume they won't be
-// checking for more probabilities)
-static bool probability_hit(unsigned int& randnum, const double probability, const unsigned long randMax)
-{
-	const unsigned long border = intRound(randMax * probability);
-	if(randnum <= border)
-		return true;
+	Point location(GETSIZEDRANDOM(x), GETSIZEDRANDOM(y));
+#undef GETSIZEDRANDOM
 
-	randnum -= border;
-	return false;
+	return Bounds(location, Point(location.x + size, location.y + size));
 }
 
-void remove_ptr_from_game_objects(const GameWorld::SpawnPtr& ptr, ZippedUniqueObjectCollection& gameObjects)
+// shrink the square _bounds_ to _newSize_, about its center
+static void shrink_down(Bounds& bounds, const unsigned short newSize)
 {
-	gameObjects.Remove(*ptr);
+	const unsigned short size = bounds.max.x - bounds.min.x;
+	if(newSize > size)
+		LOGDEBUG("New size passed to shrink_down is greater than current size")
+
+	const unsigned short sizeDiff = size - newSize;
+	bounds.min.x += sizeDiff / 2;
+	bounds.min.y += sizeDiff / 2;
+	bounds.max.x = bounds.min.x + newSize;
+	bounds.max.y = bounds.min.y + newSize;
 }
 
-void remove_pair_from_game_objects(const GameWorld::FunctionalSpawnCollection::value_type& pair,
-	ZippedUniqueObjectCollection& gameObjects)
+static inline const Config::SpawnCollectionConfig::SpawnConfig* get_spawn_data(const Config& config,
+	Random& random)
 {
-	for_each(pair.second.begin(), pair.second.end(),
-		boost::bind(&remove_ptr_from_game_objects, _1, boost::ref(gameObjects)));
+	const Config::SpawnCollectionConfig::SpawnCollection& spawnsConfig = config.spawns.spawnsConfig;
+	const unsigned long index = config.spawns.spawnTable.Sample(random);
+
+	return (index < spawnsConfig.size()) ? spawnsConfig[index].get() : NULL;
 }
 
-static GameWorld::SpawnPtr get_new_spawn(const Config::SpawnCollectionConfig::SpawnConfig& spawnConfig)
+void GameWorld::SpawnTick()
 {
-	const Bounds& spawnBounds = Config::Get().spawns.bounds;
-	boost::minstd_rand rand(time(NULL));
+	PROFILESCOPE(spawnLoop)
 
-	// get random number between the worldBounds
-#define GETSIZEDRANDOM(m) (rand() % ( \
-	(spawnBounds.max.m - spawnBounds.min.m) - (spawnConfig.size + spawnConfig.cushion) + 1) + spawnBounds.min.m)
+	if(spawnTimer.ResetIfHasElapsed(config->spawns.period))
+	{
+		const Config::SpawnCollectionConfig::SpawnConfig* const spawnConfig = get_spawn_data(*config, random);
+		if(spawnConfig)
+		{
+			Bounds bounds;
+			do
+				bounds = get_new_spawn_bounds(*spawnConfig, *config, random);
+			while(level->AnyWall(bounds) || Physics::AnyCollide(bounds, gameObjects.physics) ||
+				Physics::AnyCollide(bounds, gameObjects.entities));
 
-	Point location(GETSIZEDRANDOM(x), GETSIZEDRANDOM(y));
-#undef GETSIZEDRANDOM
+			shrink_down(bounds, spawnConfig->size);
 
-	return spawnConfig.ConstructSpawn(location);
+			DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+				spawnConfig->ConstructSpawn(gameObjects.entities, bounds, clock.GetTime() + spawnConfig->expiry);
+			)
+
+			PlaySound(config->resources.spawn);
+			LOGDEBUG("Spawn")
+		}
+	}
+
+	// remove the expired spawns, from the back, so that the ones moved into their places were already checked
+	EntityStore& entities = gameObjects.entities;
+	const EntityStore::TimeArray& expiryTimes = entities.GetExpiryTimes();
+	for(EntityStore::Index i = entities.GetCount(); i-- > 0;)
+	{
+		if(expiryTimes[i] < clock.GetTime())
+		{
+			DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+				entities.Destroy(entities.GetID(i));
+			)
+		}
+	}
 }
 
-static inline const Config::SpawnCollectionConfig::SpawnConfig* get_spawn_data()
+const Clock::TimeType GameWorld::tickLength = 5;
+
+GameWorld::Input::Input(const Type _type, const Uint32 _value) :
+	type(_type), value(_value)
 {
-	boost::minstd_rand rand(time(NULL));
+}
 
-	// food appearance rates can't have a higher resolution than 1 / randMax
-	const unsigned long randMax = 1000;
-	unsigned int randnum = rand() % (randMax + 1);
+GameWorld::GameWorld(const ConfigPtr& _config, ZippedUniqueObjectCollection& _gameObjects,
+	const unsigned long _seed) :
+	config(_config), gameObjects(_gameObjects), seed(_seed), random(_seed), tick(0), recorder(NULL),
+	spawnTimer(clock), occupancy(config->world.w, config->world.h),
+	player(*config, clock, random, occupancy, gameObjects)
+{
+	LoadLevel(*config);
+	RebuildOccupancy();
+	StreamChunks(false);
+}
 
-	const Config::SpawnCollectionConfig::SpawnCollection& spawnsConfig = Config::Get().spawns.spawnsConfig;
-	for(Config::SpawnCollectionConfig::SpawnCollection::const_iterator i = spawnsConfig.begin(), end = spawnsConfig.end();
-		i != end; ++i)
-		if(probability_hit(randnum, (*i)->rate, randMax))
-			return &**i;
+static inline bool same_color(const Config::ColorConfig& color1, const Config::ColorConfig& color2)
+{
+	return (color1.r == color2.r && color1.g == color2.g && color1.b == color2.b);
+}
 
-	return NULL;
+static inline bool same_bounds(const Config::BoundsConfig& bounds1, const Config::BoundsConfig& bounds2)
+{
+	return (bounds1.min.x == bounds2.min.x && bounds1.min.y == bounds2.min.y &&
+		bounds1.max.x == bounds2.max.x && bounds1.max.y == bounds2.max.y);
 }
 
-void GameWorld::SpawnLoop()
+static bool same_level(const Config& config1, const Config& config2)
 {
-	Timer spawnTimer;
+	const Config::LoadableCollection<Config::WallConfig>::Collection& walls1 = config1.wallsConfig.list;
+	const Config::LoadableCollection<Config::WallConfig>::Collection& walls2 = config2.wallsConfig.list;
 
-	while(!reset)
-	{
-		if(spawnTimer.ResetIfHasElapsed(Config::Get().spawns.period))
-		{
-			const Config::SpawnCollectionConfig::SpawnConfig* const spawnConfig = get_spawn_data();
-			if(spawnConfig)
-			{
-				SpawnPtr spawn;
-				do
-				{
-					spawn = get_new_spawn(*spawnConfig);
-					SDL_Delay(10);
-				}
-				while(Physics::AnyCollide(*spawn, gameObjects.physics));
-
-				spawn->ShrinkDown(spawnConfig->size);
-
-				// TODO: remove collided spawns
-				DOLOCKEDZ(gameObjects,
-					DOLOCKED(spawnMutex,
-						const Clock::TimeType expiryTime = Clock::Get().GetTime() + spawnConfig->expiry;
-						SpawnCollection& equalSpawns = spawns[expiryTime];
-						equalSpawns.push_back(SpawnPtr(spawn));
-						gameObjects.Add(*equalSpawns.back());
-
-						play_spawn_sound();
-						Logger::Debug("Spawn");
-					)
-				)
-			}
-		}
+	if(config1.world.w != config2.world.w || config1.world.h != config2.world.h ||
+		config1.world.chunkSize != config2.world.chunkSize || config1.world.level != config2.world.level)
+		return false;
 
-		// if the first set of spawns in the map is expired, remove the set
-		DOLOCKED(spawnMutex,
-			if(spawns.size() > 0)
-			{
-				const FunctionalSpawnCollection::value_type& firstSet = *spawns.begin();
-
-				if(firstSet.first < Clock::Get().GetTime())
-				{
-					DOLOCKEDZ(gameObjects,
-						remove_pair_from_game_objects(firstSet, gameObjects);
-					)
-					spawns.erase(firstSet.first);
-				}
-			}
-		)
+	if(walls1.size() != walls2.size())
+		return false;
 
-		SDL_Delay(100);
-	}
-	
-	DOLOCKEDZ(gameObjects,
-		DOLOCKED(spawnMutex,
-			for_each(spawns.begin(), spawns.end(),
-				boost::bind(&remove_pair_from_game_objects, _1, boost::ref(gameObjects)));
-		)
-	)
-}
+	for(unsigned long i = 0; i < walls1.size(); ++i)
+		if(!same_bounds(walls1[i].bounds, walls2[i].bounds) || !same_color(walls1[i].color, walls2[i].color))
+			return false;
 
-void GameWorld::Init()
-{
-	reset = false;
-	spawnThread = boost::thread(boost::bind(&GameWorld::SpawnLoop, this));
+	return true;
 }
 
-GameWorld::GameWorld(ZippedUniqueObjectCollection& _gameObjects) :
-	gameObjects(_gameObjects), player(gameObjects)
+void GameWorld::SetConfig(const ConfigPtr& newConfig)
 {
-	make_walls(walls);
-	DOLOCKEDZ(gameObjects,
-		gameObjects.AddRange(walls.begin(), walls.end());
+	DOLOCKED(configMutex,
+		pendingConfig = newConfig;
 	)
-	
-	Init();
 }
 
-void GameWorld::Update()
+void GameWorld::ApplyPendingConfig()
 {
-	player.Update(gameObjects);
-}
+	ConfigPtr newConfig;
+	DOLOCKED(configMutex,
+		newConfig.swap(pendingConfig);
+	)
 
-void GameWorld::Reset()
-{
-	reset = true;
-	player.Reset(gameObjects);
+	if(newConfig.get() == NULL)
+		return;
 
-	// wait for everything to finish
-	spawnThread.join();
+	if(!same_level(*config, *newConfig))
+	{
+		LOGDEBUG("Config reloaded: rebuilding the level")
+		LoadLevel(*newConfig);
+	}
+	else
+	{
+		LOGDEBUG("Config reloaded")
+		chunks.SetBudget(newConfig->world.chunkBudget);
+	}
 
-	spawns.clear();
+	// the spawn table and everything else is read straight from the config, so swapping it in
+	// is enough. The old one lives on for as long as the main thread is still using it.
+	player.SetConfig(*newConfig);
+	config = newConfig;
 
-	Init();
+	occupancy.Resize(config->world.w, config->world.h);
+	RebuildOccupancy();
 }
 
 static Direction get_direction_from_key(const SDLKey key)
@@ -237,7 +249,7 @@ static Direction get_direction_from_key(const SDLKey key)
 	}
 }
 
-Direction get_direction_from_button(const Uint8 button)
+static Direction get_direction_from_button(const Uint8 button)
 {
 	switch(button)
 	{
@@ -252,50 +264,431 @@ Direction get_direction_from_button(const Uint8 button)
 	}
 }
 
-void GameWorld::CollisionHandler(WorldObject& o1, WorldObject& o2)
+void GameWorld::ApplyInputs()
 {
-	DOLOCKED(o2.mutex,
-		o1.CollisionHandler(o2);
+	DOLOCKED(inputMutex,
+		tickInputs.swap(inputs);
 	)
-	DOLOCKED(o1.mutex,
-		o2.CollisionHandler(o1);
+
+	for(InputQueue::const_iterator i = tickInputs.begin(), end = tickInputs.end(); i != end; ++i)
+	{
+		if(i->type == Input::key)
+			player.ChangeDirection(get_direction_from_key(static_cast<SDLKey>(i->value)), gameObjects);
+		else
+			player.Turn(get_direction_from_button(static_cast<Uint8>(i->value)), gameObjects);
+
+		if(recorder != NULL)
+			recorder->RecordInput(tick, *i);
+	}
+
+	tickInputs.clear();
+}
+
+void GameWorld::Step()
+{
+	clock.Advance(tickLength);
+
+	ApplyPendingConfig();
+	ApplyInputs();
+	StreamChunks(true);
+
+	const bool crashed = player.Update(gameObjects);
+	SpawnTick();
+
+	// gather collisions first, and resolve them once the physics objects are unlocked.
+	// The snake running into walls or itself was already found through _occupancy_, so this is
+	// only the snake running into spawns.
+	collisions.clear();
+	DOLOCKEDP(physicsLockWait, gameObjects.physics.mutex,
+		Physics::Update(gameObjects.physics, gameObjects.entities, collisions, WorldObject::snake);
 	)
 
-	const unsigned long collisionType = o1.GetObjectType() | o2.GetObjectType();
-	const bool selfCollide = !(collisionType & ~o1.GetObjectType());
+	if(CollisionHandler(collisions, crashed))
+		Reset();
+
+	++tick;
+
+	if(recorder != NULL)
+		recorder->RecordHash(GetStateHash());
+}
+
+void GameWorld::Reset()
+{
+	player.Reset(gameObjects);
 
-	if(collisionType & WorldObject::snake)
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		gameObjects.entities.Clear();
+	)
+	spawnTimer.Reset();
+
+	for(ChunkCache::ChunkIndexArray::const_iterator i = spawnedChunks.begin(), end = spawnedChunks.end(); i != end; ++i)
+		chunkSpawned[*i] = false;
+	spawnedChunks.clear();
+
+	// the snake's head may have been over a wall
+	RebuildOccupancy();
+}
+
+void GameWorld::RebuildOccupancy()
+{
+	occupancy.Clear();
+	chunks.SetOccupancy(occupancy);
+
+	std::vector<WorldObject*> segments;
+	player.GetSegments(segments);
+	for(std::vector<WorldObject*>::const_iterator i = segments.begin(), end = segments.end(); i != end; ++i)
+		occupancy.Set((*i)->GetBounds());
+}
+
+void GameWorld::LoadLevel(const Config& newConfig)
+{
+	std::auto_ptr<const Level> newLevel(make_level(newConfig));
+	chunks.SetLevel(newLevel.get(), gameObjects, occupancy);
+	chunks.SetBudget(newConfig.world.chunkBudget);
+	level = newLevel;
+
+	// the static spawns already spawned stay, but new ones come from the new level's chunks
+	chunkSpawned.assign(level->GetChunkCount(), false);
+	spawnedChunks.clear();
+}
+
+void GameWorld::StreamChunks(const bool spawnStatics)
+{
+	std::vector<Bounds> cleared;
+	chunks.Update(get_needed_region(*config, player.GetHeadBounds(), level->GetChunkSize()), gameObjects, occupancy,
+		cleared);
+
+	// evicting a chunk clears its whole area, including any of the snake that was in it
+	if(!cleared.empty())
 	{
-		if(selfCollide || collisionType & WorldObject::wall	|| collisionType & WorldObject::mine)
+		std::vector<WorldObject*> segments;
+		player.GetSegments(segments);
+		for(std::vector<WorldObject*>::const_iterator i = segments.begin(), end = segments.end(); i != end; ++i)
 		{
-			DOLOCKED(EventHandler::mutex,
-				EventHandler::Get()->LossCallback();
-			)
-			play_death_sound();
+			const Bounds bounds = (*i)->GetBounds();
+			for(std::vector<Bounds>::const_iterator area = cleared.begin(), areasEnd = cleared.end(); area != areasEnd; ++area)
+				if(bounds.Overlaps(*area))
+					occupancy.Set(bounds);
 		}
-		else if(collisionType & WorldObject::food)
+	}
+
+	if(spawnStatics)
+	{
+		const ChunkCache::ChunkIndexArray& needed = chunks.GetNeeded();
+		for(ChunkCache::ChunkIndexArray::const_iterator i = needed.begin(), end = needed.end(); i != end; ++i)
+			if(!chunkSpawned[*i] && level->GetChunk(*i).spawnCount > 0)
+				SpawnStatics(*i);
+	}
+}
+
+void GameWorld::SpawnStatics(const ChunkCache::ChunkIndex chunk)
+{
+	const Level::Compiled::Chunk& records = level->GetChunk(chunk);
+
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		for(const Level::Compiled::Spawn* spawn = level->GetSpawns() + records.firstSpawn, * const end = spawn + records.spawnCount;
+			spawn != end; ++spawn)
 		{
-			play_eat_sound();
-			DOLOCKED(spawnMutex,
-				Food* const toRemove = static_cast<Food*>(
-					(o1.GetObjectType() == WorldObject::food) ? &o1 : &o2);
-
-				DOLOCKEDZ(gameObjects,
-					gameObjects.Remove(*toRemove);
-				)
-			)
+			// checked here rather than when the level is mapped, so that the spawns are only read once needed
+			if(spawn->type != WorldObject::food && spawn->type != WorldObject::mine)
+			{
+				LOGDEBUG(boost::format("Skipping static spawn of unknown type %1%") % static_cast<unsigned int>(spawn->type))
+				continue;
+			}
+
+			gameObjects.entities.Create(static_cast<WorldObject::ObjectType>(spawn->type), spawn->GetBounds(),
+				spawn->GetColor(), std::numeric_limits<Clock::TimeType>::max(),
+				EntityStore::FoodEffects(spawn->pointChange, spawn->lengthFactor, spawn->speedChange));
+		}
+	)
+
+	chunkSpawned[chunk] = true;
+	spawnedChunks.push_back(chunk);
+}
+
+bool GameWorld::CollisionHandler(const Physics::EntityCollisionQueue& collisions, const bool crashed)
+{
+	if(collisions.empty() && !crashed)
+		return false;
+
+	PROFILESCOPE(collisionResolve)
+
+	// the side-effects of this batch, so that each happens at most once
+	bool died = crashed;
+	bool ate = false;
+
+	EntityStore& entities = gameObjects.entities;
+	DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+		for(Physics::EntityCollisionQueue::const_iterator i = collisions.begin(), end = collisions.end(); i != end; ++i)
+		{
+			// a food touching multiple snake segments is destroyed the first time, so it's only eaten once
+			if(!entities.IsLive(i->second))
+				continue;
+
+			const EntityStore::Index index = entities.GetIndex(i->second);
+			if(entities.GetTypes()[index] == WorldObject::mine)
+				died = true;
+			else if(entities.GetTypes()[index] == WorldObject::food)
+			{
+				player.EatFood(entities.GetFoodEffects()[index]);
+				entities.Destroy(i->second);
+				ate = true;
+			}
 		}
+	)
+
+	if(died)
+	{
+		if(lossCallback)
+			lossCallback();
+		PlaySound(config->resources.die);
 	}
+
+	if(ate)
+		PlaySound(config->resources.eat);
+
+	return died;
 }
 
 void GameWorld::KeyNotify(const SDLKey key)
 {
 	if(key == SDLK_LEFT || key == SDLK_RIGHT || key == SDLK_UP || key == SDLK_DOWN)
-		player.ChangeDirection(get_direction_from_key(key), gameObjects);
+	{
+		DOLOCKED(inputMutex,
+			inputs.push_back(Input(Input::key, key));
+		)
+	}
 }
 
 void GameWorld::MouseNotify(Uint8 button)
 {
 	if(button == SDL_BUTTON_LEFT || button == SDL_BUTTON_RIGHT)
-		player.Turn(get_direction_from_button(button), gameObjects);
+	{
+		DOLOCKED(inputMutex,
+			inputs.push_back(Input(Input::mouse, button));
+		)
+	}
+}
+
+void GameWorld::PlaySound(const std::string& filename) const
+{
+	if(soundCallback)
+		soundCallback(filename);
+}
+
+void GameWorld::SetCallbacks(const SoundCallback& onSound, const LossCallback& onLoss)
+{
+	soundCallback = onSound;
+	lossCallback = onLoss;
+}
+
+void GameWorld::SetRecorder(InputRecorder* const _recorder)
+{
+	recorder = _recorder;
+}
+
+const Clock& GameWorld::GetClock() const
+{
+	return clock;
+}
+
+unsigned long GameWorld::GetSeed() const
+{
+	return seed;
+}
+
+GameWorld::TickType GameWorld::GetTick() const
+{
+	return tick;
+}
+
+static void hash_bounds(StateHash& hash, const Bounds& bounds)
+{
+	hash.Add(bounds.min.x);
+	hash.Add(bounds.min.y);
+	hash.Add(bounds.max.x);
+	hash.Add(bounds.max.y);
+}
+
+StateHash::ValueType GameWorld::GetStateHash() const
+{
+	StateHash hash;
+
+	hash.Add(tick);
+	hash.Add(clock.GetTime());
+	// the next random number stands in for the generator's state
+	hash.Add(Random(random)());
+
+	player.AddToHash(hash);
+
+	const EntityStore& entities = gameObjects.entities;
+	for(EntityStore::Index i = 0, count = entities.GetCount(); i < count; ++i)
+	{
+		hash.Add(entities.GetExpiryTimes()[i]);
+		hash.Add(entities.GetTypes()[i]);
+		hash_bounds(hash, entities.GetBounds()[i]);
+	}
+
+	for(ChunkCache::ChunkIndexArray::const_iterator i = spawnedChunks.begin(), end = spawnedChunks.end(); i != end; ++i)
+		hash.Add(*i);
+
+	return hash.GetValue();
+}
+
+// snapshots start with these, so that other files (and snapshots from other versions) are refused
+static const boost::uint32_t snapshotMagic = 0x504e534b; // "KSNP"
+static const boost::uint32_t snapshotVersion = 8;
+
+// minstd_rand's state is just its last output, but it's only exposed through streams
+static boost::uint32_t get_random_state(const Random& random)
+{
+	std::ostringstream state;
+	state << random;
+	return strtoul(state.str().c_str(), NULL, 10);
+}
+
+void GameWorld::GetObjects(std::vector<WorldObject*>& objects)
+{
+	player.GetSegments(objects);
+}
+
+// The order of the game objects matters (e.g. it's the order collisions are resolved in), so it's
+// saved as well, as each game object's index in GetObjects().
+typedef std::pair<const WorldObject*, boost::uint32_t> ObjectIndex;
+
+void GameWorld::SaveSnapshot(std::ostream& out)
+{
+	SnapshotWriter archive(out, snapshotArchiveFlags);
+
+	boost::uint32_t magic = snapshotMagic;
+	boost::uint32_t version = snapshotVersion;
+	boost::uint32_t chunkCount = level->GetChunkCount();
+	boost::uint32_t wallCount = level->GetWallCount();
+	archive & magic & version & chunkCount & wallCount;
+
+	Clock::TimeType time = clock.GetTime();
+	boost::uint32_t randomState = get_random_state(random);
+	archive & seed & tick & time & randomState;
+
+	spawnTimer.Serialize(archive);
+	player.Serialize(archive);
+	gameObjects.entities.Serialize(archive);
+
+	boost::uint32_t spawnedCount = spawnedChunks.size();
+	archive & spawnedCount;
+	for(boost::uint32_t i = 0; i < spawnedCount; ++i)
+		archive & spawnedChunks[i];
+
+	std::vector<WorldObject*> objects;
+	GetObjects(objects);
+
+	std::vector<ObjectIndex> indices;
+	indices.reserve(objects.size());
+	for(boost::uint32_t i = 0; i < objects.size(); ++i)
+		indices.push_back(ObjectIndex(objects[i], i));
+	std::sort(indices.begin(), indices.end());
+
+	DOLOCKEDP(physicsLockWait, gameObjects.physics.mutex,
+		boost::uint32_t objectCount = gameObjects.physics.end() - gameObjects.physics.begin();
+		archive & objectCount;
+
+		for(UniqueObjectCollection::const_iterator i = gameObjects.physics.begin(), end = gameObjects.physics.end();
+			i != end; ++i)
+		{
+			boost::uint32_t index = std::lower_bound(indices.begin(), indices.end(), ObjectIndex(*i, 0))->second;
+			archive & index;
+		}
+	)
+}
+
+bool GameWorld::LoadSnapshot(std::istream& in)
+{
+	SnapshotReader archive(in, snapshotArchiveFlags);
+
+	boost::uint32_t magic, version, chunkCount, wallCount;
+	try
+	{
+		archive & magic & version & chunkCount & wallCount;
+	}
+	catch(const boost::archive::archive_exception&)
+	{
+		// too short to even be a snapshot
+		magic = 0;
+	}
+
+	if(magic != snapshotMagic || version != snapshotVersion)
+	{
+		LOGDEBUG("Not a snapshot, or a snapshot from another version")
+		return false;
+	}
+
+	if(chunkCount != level->GetChunkCount() || wallCount != level->GetWallCount())
+	{
+		LOGDEBUG("Snapshot was taken with a different level")
+		return false;
+	}
+
+	// a snapshot that's cut short or corrupt throws partway through, so the error is kept until the locks
+	// have been released
+	std::string error;
+	DOLOCKEDZ(gameObjects,
+		try
+		{
+			// everything in the game objects is about to be replaced, and the chunks are loaded again afterwards
+			chunks.Clear(gameObjects);
+			gameObjects.Clear();
+
+			Clock::TimeType time;
+			boost::uint32_t randomState;
+			archive & seed & tick & time & randomState;
+			clock.SetTime(time);
+			random.seed(randomState);
+
+			spawnTimer.Serialize(archive);
+			player.Serialize(archive);
+			gameObjects.entities.Serialize(archive);
+			gameObjects.focus = player.GetHeadBounds();
+
+			boost::uint32_t spawnedCount;
+			archive & spawnedCount;
+			spawnedChunks.resize(spawnedCount);
+			chunkSpawned.assign(chunkSpawned.size(), false);
+			for(boost::uint32_t i = 0; i < spawnedCount; ++i)
+			{
+				archive & spawnedChunks[i];
+				if(spawnedChunks[i] >= chunkSpawned.size())
+					throw std::runtime_error((boost::format("out-of-range chunk %1%") % spawnedChunks[i]).str());
+
+				chunkSpawned[spawnedChunks[i]] = true;
+			}
+
+			std::vector<WorldObject*> objects;
+			GetObjects(objects);
+
+			boost::uint32_t objectCount;
+			archive & objectCount;
+			for(boost::uint32_t i = 0; i < objectCount; ++i)
+			{
+				boost::uint32_t index;
+				archive & index;
+
+				if(index >= objects.size())
+					throw std::runtime_error((boost::format("out-of-range object %1%") % index).str());
+
+				gameObjects.Add(*objects[index]);
+			}
+		}
+		catch(const std::exception& e)
+		{
+			error = e.what();
+		}
+	)
+
+	if(!error.empty())
+		Logger::Fatal(boost::format("Unable to load snapshot: %1%") % error);
+
+	RebuildOccupancy();
+	StreamChunks(false);
+
+	return true;
 }
@@ -1,67 +1,176 @@
 #pragma once
 
+#include "ChunkCache.hpp"
 #include "Clock.hpp"
-#include "Food.hpp"
-#include "Mine.hpp"
+#include "Level.hpp"
 #include "Mutex.hpp"
+#include "OccupancyGrid.hpp"
+#include "Physics.hpp"
+#include "Random.hpp"
 #include "Snake.hpp"
 #include "Sound.hpp"
+#include "StateHash.hpp"
 #include "Timer.hpp"
-#include "Wall.hpp"
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
+#include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/thread.hpp>
-#include <list>
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <SDL_events.h>
+#include <string>
+#include <vector>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
+struct Config;
+class InputRecorder;
 struct ZippedUniqueObjectCollection;
 
+// The whole simulation (snake, spawns, physics and collisions) moves forward in fixed ticks,
+// all on whichever thread calls Step(). Given the same config, seed and inputs at the same ticks,
+// a game world always goes through exactly the same states, so a game can be recorded and
+// replayed (see InputRecorder and InputPlayer). Game worlds don't share any state, so any number
+// of them can be stepped at once, on different threads.
+
 class GameWorld
 {
 public:
-	typedef boost::shared_ptr<Spawn> SpawnPtr;
-	typedef std::list<SpawnPtr> SpawnCollection;
-	// a spawn list whose key is expiry time
-	typedef std::map<Clock::TimeType, SpawnCollection> FunctionalSpawnCollection;
-	typedef std::vector<Wall> WallCollection;
+	typedef boost::shared_ptr<const Config> ConfigPtr;
+	typedef unsigned long long TickType;
+
+	// a key press or mouse click, which is applied at the start of the next tick
+	struct Input
+	{
+		// the values are the ones used in recordings
+		enum Type
+		{
+			key = 0,
+			mouse = 1
+		};
+
+		Type type;
+		// the key code, or mouse button
+		Uint32 value;
+
+		Input(Type type, Uint32 value);
+	};
+	typedef std::vector<Input> InputQueue;
+
+	// called from Step() to play a sound, and when the snake dies
+	typedef boost::function<void (const std::string& filename)> SoundCallback;
+	typedef boost::function<void ()> LossCallback;
+
+	// the game time that passes in one tick
+	static const Clock::TimeType tickLength;
 
 private:
-	void SpawnLoop();
-
+	// the live config, and a reloaded one waiting for the next tick (guarded by _configMutex_)
+	ConfigPtr config;
+	ConfigPtr pendingConfig;
+	Mutex configMutex;
 	ZippedUniqueObjectCollection& gameObjects;
 
-	FunctionalSpawnCollection spawns;
-	Mutex spawnMutex;
+	Clock clock;
+	unsigned long seed;
+	Random random;
+	// the number of ticks stepped so far
+	TickType tick;
 
-	boost::thread spawnThread;
+	// inputs waiting for the next tick
+	InputQueue inputs;
+	Mutex inputMutex;
+	// the inputs being applied this tick
+	InputQueue tickInputs;
 
-	// whether or not to reset the game
-	bool reset;
+	InputRecorder* recorder;
 
-	Snake player;
+	SoundCallback soundCallback;
+	LossCallback lossCallback;
 
-	WallCollection walls;
+	// the spawns themselves are _gameObjects_' entities
+	Timer spawnTimer;
 
-	void Init();
+	// the pixels covered by walls and the snake, for finding when the snake runs into either
+	OccupancyGrid occupancy;
+	Snake player;
 
-public:
-	GameWorld(ZippedUniqueObjectCollection& gameObjects);
+	// the walls and static spawns, and the chunks of them which are loaded around the snake. Which chunks
+	// are loaded doesn't affect the game; only whose static spawns have been spawned this game does.
+	std::auto_ptr<const Level> level;
+	ChunkCache chunks;
+	std::vector<bool> chunkSpawned;
+	// the chunks in _chunkSpawned_, in the order their static spawns were spawned
+	ChunkCache::ChunkIndexArray spawnedChunks;
 
-	void Update();
-	void Reset();
+	Physics::EntityCollisionQueue collisions;
 
-	// handle all the non object-specific side-effects of collisions (e.g. sound effects)
-	void CollisionHandler(WorldObject&, WorldObject&);
+	void SpawnTick();
+	// apply the queued inputs, recording them if there's a recorder
+	void ApplyInputs();
+	// start a new game, after the snake died
+	void Reset();
+	// rebuild _occupancy_ from scratch, from the loaded walls and the snake
+	void RebuildOccupancy();
+	// start using the level (and chunk budget) from _config_, dropping every loaded chunk
+	void LoadLevel(const Config& config);
+	// load the chunks around the snake, and (if _spawnStatics_) spawn the static spawns of any of them
+	// which haven't been needed yet this game
+	void StreamChunks(bool spawnStatics);
+	void SpawnStatics(ChunkCache::ChunkIndex chunk);
+	// get every physics object this world owns (i.e. the snake's segments), in an order
+	// which only depends on the state of the game
+	void GetObjects(std::vector<WorldObject*>& objects);
+	void PlaySound(const std::string& filename) const;
+
+	// start using _pendingConfig_, if there is one
+	void ApplyPendingConfig();
 
+public:
+	// _seed_ seeds everything random in the game
+	GameWorld(const ConfigPtr& config, ZippedUniqueObjectCollection& gameObjects, unsigned long seed);
+
+	// move the whole simulation (including the game clock) forward by one tick
+	void Step();
+	// switch to _config_ at the start of the next tick, rebuilding the walls and
+	// spawn table, but keeping the snake and anything already spawned
+	void SetConfig(const ConfigPtr& config);
+
+	// resolve a physics pass' worth of the snake's collisions with spawns in one batch, handling all
+	// the non object-specific side-effects (e.g. sound effects) at most once each.
+	// _crashed_ is whether the snake already ran into a wall or itself this tick (see Snake::Update).
+	// Returns true iff the snake died.
+	bool CollisionHandler(const Physics::EntityCollisionQueue& collisions, bool crashed);
+
+	// queue an input for the next tick. These can be called from any thread.
 	void KeyNotify(SDLKey key);
 	void MouseNotify(Uint8 mouseButton);
+
+	// set the callbacks for sounds and deaths (either of which can be empty, which is the default)
+	void SetCallbacks(const SoundCallback& onSound, const LossCallback& onLoss);
+
+	// record every tick's inputs and state hash to _recorder_ (or stop recording, if it's NULL)
+	void SetRecorder(InputRecorder* recorder);
+
+	// Write the whole state of the game (the snake, spawns, timers, random number generator, tick and
+	// clock) to _out_. Call this between ticks. The level and everything else that comes from the config
+	// aren't included, so snapshots have to be loaded with the same config.
+	void SaveSnapshot(std::ostream& out);
+	// replace the state of the game with a snapshot written by SaveSnapshot. Returns false (leaving
+	// the game as it was) if _in_ isn't a snapshot from this version, or doesn't fit the level.
+	// Snapshots that are cut short are fatal.
+	bool LoadSnapshot(std::istream& in);
+
+	// the game time, which can be read from any thread
+	const Clock& GetClock() const;
+	unsigned long GetSeed() const;
+	TickType GetTick() const;
+	// hash everything which affects how the game plays out from here on
+	StateHash::ValueType GetStateHash() const;
 };
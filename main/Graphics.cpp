@@ -1,6 +1,10 @@
 #include "Graphics.hpp"
 
+#include "Camera.hpp"
 #include "Common.hpp"
+#include "EntityStore.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
 #include "Screen.hpp"
 #include "UniqueObjectCollection.hpp"
 #include "WorldObject.hpp"
@@ -10,7 +14,7 @@
 #endif
 
 #include <algorithm>
-#include <boost/bind.hpp>
+#include <cstdlib>
 
 #ifdef MSVC
 #pragma warning(pop)
@@ -18,12 +22,156 @@
 
 namespace Graphics
 {
-	void Update(const UniqueObjectCollection& graphicsObjects, const Screen& target)
+	Background::Background() :
+		wallsVersion(0), origin(0, 0)
 	{
-		target.Clear();
+	}
+
+	Background::~Background()
+	{
+	}
+
+	void Background::IndexWalls(const UniqueObjectCollection& graphicsObjects)
+	{
+		walls.clear();
+		Bounds area(Point(0, 0), Point(0, 0));
+
+		for(UniqueObjectCollection::const_iterator i = graphicsObjects.begin(), end = graphicsObjects.end();
+			i != end; ++i)
+		{
+			if((*i)->GetObjectType() != WorldObject::wall)
+				continue;
+
+			const Bounds bounds = (*i)->GetBounds();
+			if(walls.empty())
+				area = bounds;
+
+			area.min.x = std::min(area.min.x, bounds.min.x);
+			area.min.y = std::min(area.min.y, bounds.min.y);
+			area.max.x = std::max(area.max.x, bounds.max.x);
+			area.max.y = std::max(area.max.y, bounds.max.y);
+			walls.push_back(*i);
+		}
+
+		wallIndex.Reset(area);
+		for(std::vector<const WorldObject*>::const_iterator i = walls.begin(), end = walls.end(); i != end; ++i)
+			wallIndex.Insert((*i)->GetBounds());
+	}
+
+	// the part of _bounds_ inside _area_
+	static inline Bounds clip_to(const Bounds& bounds, const Bounds& area)
+	{
+		return Bounds(Point(std::max(bounds.min.x, area.min.x), std::max(bounds.min.y, area.min.y)),
+			Point(std::min(bounds.max.x, area.max.x), std::min(bounds.max.y, area.max.y)));
+	}
+
+	void Background::DrawArea(const Bounds& area, const Camera& camera)
+	{
+		cache->Clear(camera.ToScreen(area));
+
+		// in insertion order, which is the order they're in _graphicsObjects_. Only the part of each wall
+		// inside _area_ is drawn, so that the rest of _cache_ is left alone.
+		visibleWalls.clear();
+		wallIndex.Query(area, visibleWalls);
+		for(std::vector<SpatialIndex::Item>::const_iterator i = visibleWalls.begin(), end = visibleWalls.end();
+			i != end; ++i)
+		{
+			const WorldObject& wall = *walls[*i];
+			cache->Fill(camera.ToScreen(clip_to(wall.GetBounds(), area)), Palette::GetColor(wall.GetColor()));
+		}
+	}
+
+	void Background::Refresh(const UniqueObjectCollection& graphicsObjects, const Camera& camera,
+		const Screen& target)
+	{
+		const bool wallsChanged = (cache.get() == NULL || wallsVersion != graphicsObjects.GetWallsVersion());
+		if(!wallsChanged && origin == camera.GetOrigin())
+			return;
+
+		const Bounds view = camera.GetView();
+		// how far what's already in _cache_ moves on the screen
+		const Vector2D shift = origin - camera.GetOrigin();
+		origin = camera.GetOrigin();
+
+		if(wallsChanged)
+		{
+			IndexWalls(graphicsObjects);
+			cache.reset(target.MakeOffscreen());
+			spare.reset(target.MakeOffscreen());
+			wallsVersion = graphicsObjects.GetWallsVersion();
+			LOGDEBUG(boost::format("Indexed %1% walls") % walls.size())
+
+			DrawArea(view, camera);
+			return;
+		}
+
+		const Point viewSize = view.max - view.min;
+		if(std::abs(shift.x) >= viewSize.x || std::abs(shift.y) >= viewSize.y)
+		{
+			DrawArea(view, camera);
+			return;
+		}
+
+		spare->Blit(*cache, shift);
+		std::auto_ptr<const Screen> shifted(spare);
+		spare = cache;
+		cache = shifted;
+
+		// the column that came into view, then the rest of the row that did
+		Bounds remaining = view;
+		if(shift.x > 0)
+		{
+			DrawArea(Bounds(view.min, Point(view.min.x + shift.x, view.max.y)), camera);
+			remaining.min.x += shift.x;
+		}
+		else if(shift.x < 0)
+		{
+			DrawArea(Bounds(Point(view.max.x + shift.x, view.min.y), view.max), camera);
+			remaining.max.x += shift.x;
+		}
+
+		if(shift.y > 0)
+			DrawArea(Bounds(remaining.min, Point(remaining.max.x, remaining.min.y + shift.y)), camera);
+		else if(shift.y < 0)
+			DrawArea(Bounds(Point(remaining.min.x, remaining.max.y + shift.y), remaining.max), camera);
+	}
+
+	const Screen& Background::GetScreen() const
+	{
+		return *cache;
+	}
+
+	void Background::Draw(const UniqueObjectCollection& graphicsObjects, const Camera& camera,
+		const Screen& target)
+	{
+		Refresh(graphicsObjects, camera, target);
+		target.Blit(*cache);
+	}
+
+	static void draw_entities(const EntityStore& entities, const Camera& camera, const Screen& target)
+	{
+		const EntityStore::BoundsArray& bounds = entities.GetBounds();
+		const EntityStore::ColorArray& colors = entities.GetColors();
+		const Bounds view = camera.GetView();
+
+		for(EntityStore::Index i = 0, count = entities.GetCount(); i < count; ++i)
+			if(bounds[i].Overlaps(view))
+				target.Fill(camera.ToScreen(bounds[i]), Palette::GetColor(colors[i]));
+	}
+
+	void Update(const UniqueObjectCollection& graphicsObjects, const EntityStore& entities, Background& background,
+		const Camera& camera, const Screen& target)
+	{
+		PROFILESCOPE(graphicsUpdate)
+
+		background.Draw(graphicsObjects, camera, target);
+		draw_entities(entities, camera, target);
 
-		for_each(graphicsObjects.begin(), graphicsObjects.end(),
-			bind(&WorldObject::Draw, _1, boost::ref(target)));
+		// the walls are already in the background
+		const Bounds view = camera.GetView();
+		for(UniqueObjectCollection::const_iterator i = graphicsObjects.begin(), end = graphicsObjects.end(); i != end; ++i)
+			if((*i)->GetObjectType() != WorldObject::wall && (*i)->GetBounds().Overlaps(view))
+				(*i)->Draw(target, camera);
 
 		target.Update();
 	}
@@ -1,7 +1,75 @@
+#pragma once
+
+#include "Point.hpp"
+#include "SpatialIndex.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <memory>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+class EntityStore;
 class Screen;
 class UniqueObjectCollection;
+class WorldObject;
 
 namespace Graphics
 {
-	void Update(const UniqueObjectCollection& graphicsObjects, const Screen& target);
+	class Camera;
+
+	// The background color with the walls in view drawn over it. Walls don't move, so rather than drawing
+	// them every frame, they're drawn into this once, and each frame starts by copying it onto the screen.
+	// When the camera moves, whatever is still in view is shifted over and only the strips that came into
+	// view are drawn. The walls are kept in a spatial index, so drawing only looks at the ones in view,
+	// however big the world is.
+	class Background
+	{
+	private:
+		// NULL until the first frame
+		std::auto_ptr<const Screen> cache;
+		// the same size as _cache_, for shifting it into
+		std::auto_ptr<const Screen> spare;
+		// the walls version (see UniqueObjectCollection) _cache_ was drawn from
+		unsigned long wallsVersion;
+		// the camera origin _cache_ was drawn from
+		Point origin;
+
+		// the walls, by their items in _wallIndex_
+		std::vector<const WorldObject*> walls;
+		SpatialIndex wallIndex;
+		// the walls in view, kept between frames for its capacity
+		std::vector<SpatialIndex::Item> visibleWalls;
+
+		Background(const Background&);
+		Background& operator=(const Background&);
+
+		// rebuild _walls_ and _wallIndex_ from the walls in _graphicsObjects_
+		void IndexWalls(const UniqueObjectCollection& graphicsObjects);
+		// clear _area_ (in the world) of _cache_ and draw the walls in it, as seen by _camera_
+		void DrawArea(const Bounds& area, const Camera& camera);
+
+	public:
+		Background();
+		~Background();
+
+		// redraw this to match _target_ as seen by _camera_, if the walls in _graphicsObjects_ have
+		// changed, or the camera has moved (or it's the first frame)
+		void Refresh(const UniqueObjectCollection& graphicsObjects, const Camera& camera, const Screen& target);
+		// the background as of the last Refresh()
+		const Screen& GetScreen() const;
+
+		// Refresh(), then copy this onto _target_
+		void Draw(const UniqueObjectCollection& graphicsObjects, const Camera& camera, const Screen& target);
+	};
+
+	// draw _background_, then _entities_, then everything else in _graphicsObjects_ over them, as seen by
+	// _camera_. Anything out of view is skipped.
+	void Update(const UniqueObjectCollection& graphicsObjects, const EntityStore& entities, Background& background,
+		const Camera& camera, const Screen& target);
 }
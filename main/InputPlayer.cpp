@@ -0,0 +1,83 @@
+#include "InputPlayer.hpp"
+
+#include "InputRecorder.hpp"
+#include "Logger.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+InputPlayer::InputPlayer(const std::string& filename) :
+	file(filename.c_str(), std::ios::binary), valid(false), seed(0)
+{
+	boost::uint32_t header[4];
+	for(unsigned int i = 0; i < 4; ++i)
+		if(!Read(header[i]))
+			return;
+
+	if(header[0] != InputRecorder::magic || header[1] != InputRecorder::version)
+	{
+		LOGDEBUG(boost::format("\"%1%\" isn't a recording, or is from another version") % filename)
+		return;
+	}
+
+	if(header[3] != GameWorld::tickLength)
+	{
+		LOGDEBUG(boost::format("\"%1%\" was recorded with %2%ms ticks, not %3%ms")
+			% filename % header[3] % GameWorld::tickLength)
+		return;
+	}
+
+	seed = header[2];
+	valid = true;
+}
+
+bool InputPlayer::IsValid() const
+{
+	return valid;
+}
+
+unsigned long InputPlayer::GetSeed() const
+{
+	return seed;
+}
+
+bool InputPlayer::Step(GameWorld& world, StateHash::ValueType& expectedHash)
+{
+	boost::uint8_t type;
+	while(valid && Read(type))
+	{
+		if(type == InputRecorder::hash)
+		{
+			boost::uint64_t stateHash;
+			if(!Read(stateHash))
+				break;
+
+			world.Step();
+			expectedHash = stateHash;
+			return true;
+		}
+
+		boost::uint64_t tick;
+		boost::uint32_t value;
+		if(type > InputRecorder::mouse || !Read(tick) || !Read(value) || tick != world.GetTick())
+		{
+			LOGDEBUG(boost::format("Broken record before tick %1% of the recording") % world.GetTick())
+			break;
+		}
+
+		if(type == InputRecorder::key)
+			world.KeyNotify(static_cast<SDLKey>(value));
+		else
+			world.MouseNotify(static_cast<Uint8>(value));
+	}
+
+	valid = false;
+	return false;
+}
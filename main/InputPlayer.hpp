@@ -0,0 +1,42 @@
+#pragma once
+
+#include "GameWorld.hpp"
+#include "StateHash.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <fstream>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// plays a recording made by InputRecorder back into a game world, one tick at a time
+class InputPlayer
+{
+private:
+	std::ifstream file;
+	bool valid;
+	unsigned long seed;
+
+	template <typename T>
+	bool Read(T& value)
+	{
+		return !file.read(reinterpret_cast<char*>(&value), sizeof(value)).fail();
+	}
+
+public:
+	explicit InputPlayer(const std::string& filename);
+
+	// returns false iff the file couldn't be opened, or isn't a recording this build can play
+	bool IsValid() const;
+	// the seed to construct the game world with
+	unsigned long GetSeed() const;
+
+	// feed the inputs of _world_'s next tick into it and step it. Returns false at the end of the recording
+	// (or at the first broken record); otherwise, _expectedHash_ is the state hash recorded after that tick.
+	bool Step(GameWorld& world, StateHash::ValueType& expectedHash);
+};
@@ -0,0 +1,29 @@
+#include "InputRecorder.hpp"
+
+InputRecorder::InputRecorder(const std::string& filename, const unsigned long seed,
+	const Clock::TimeType tickLength) :
+	file(filename.c_str(), std::ios::binary)
+{
+	Write<boost::uint32_t>(magic);
+	Write<boost::uint32_t>(version);
+	Write<boost::uint32_t>(seed);
+	Write<boost::uint32_t>(tickLength);
+}
+
+bool InputRecorder::IsGood() const
+{
+	return file.good();
+}
+
+void InputRecorder::RecordInput(const GameWorld::TickType tick, const GameWorld::Input& input)
+{
+	Write<boost::uint8_t>(input.type);
+	Write<boost::uint64_t>(tick);
+	Write<boost::uint32_t>(input.value);
+}
+
+void InputRecorder::RecordHash(const StateHash::ValueType stateHash)
+{
+	Write<boost::uint8_t>(hash);
+	Write<boost::uint64_t>(stateHash);
+}
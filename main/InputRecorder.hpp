@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Clock.hpp"
+#include "GameWorld.hpp"
+#include "StateHash.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <fstream>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// Records a game as its seed, every input (with the tick it was applied at) and the state hash
+// after every tick, so that it can be replayed exactly and checked (see InputPlayer).
+//
+// A recording starts with a header of four uint32s: magic, version, seed and tick length. It's
+// followed by records, each of which starts with a uint8 RecordType:
+//	key, mouse: an input; followed by the uint64 tick and the uint32 key code or mouse button
+//	hash: the end of a tick; followed by the uint64 state hash after it
+// Everything is in the native byte order.
+class InputRecorder
+{
+public:
+	enum
+	{
+		magic = 0x524b4e53, // "SNKR"
+		version = 1
+	};
+
+	// input records use the GameWorld::Input::Type values
+	enum RecordType
+	{
+		key = GameWorld::Input::key,
+		mouse = GameWorld::Input::mouse,
+		hash = 2
+	};
+
+private:
+	std::ofstream file;
+
+	template <typename T>
+	void Write(const T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+public:
+	InputRecorder(const std::string& filename, unsigned long seed, Clock::TimeType tickLength);
+
+	// returns false iff the recording couldn't be opened, or a write has failed
+	bool IsGood() const;
+
+	void RecordInput(GameWorld::TickType tick, const GameWorld::Input& input);
+	void RecordHash(StateHash::ValueType stateHash);
+};
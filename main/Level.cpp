@@ -0,0 +1,300 @@
+#include "Level.hpp"
+
+#include "Config.hpp"
+#include "Logger.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+#include <boost/interprocess/file_mapping.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+Bounds Level::Compiled::Wall::GetBounds() const
+{
+	return Bounds(Point(minX, minY), Point(maxX, maxY));
+}
+
+Color24 Level::Compiled::Wall::GetColor() const
+{
+	return Color24(r, g, b);
+}
+
+Bounds Level::Compiled::Spawn::GetBounds() const
+{
+	return Bounds(Point(minX, minY), Point(maxX, maxY));
+}
+
+Color24 Level::Compiled::Spawn::GetColor() const
+{
+	return Color24(r, g, b);
+}
+
+Level::Level() :
+	header(NULL), chunks(NULL), walls(NULL), spawns(NULL)
+{
+}
+
+Level::Level(const Point worldSize, const unsigned long chunkSize, const WallArray& worldWalls,
+	const SpawnArray& worldSpawns)
+{
+	Build(worldSize, chunkSize, worldWalls, worldSpawns);
+}
+
+Level::Level(const Config& config)
+{
+	WallArray worldWalls;
+	worldWalls.reserve(config.wallsConfig.list.size());
+
+	for(Config::LoadableCollection<Config::WallConfig>::const_iterator i = config.wallsConfig.begin(),
+		end = config.wallsConfig.end(); i != end; ++i)
+	{
+		Compiled::Wall wall;
+		wall.minX = i->bounds.min.x;
+		wall.minY = i->bounds.min.y;
+		wall.maxX = i->bounds.max.x;
+		wall.maxY = i->bounds.max.y;
+		wall.r = i->color.r;
+		wall.g = i->color.g;
+		wall.b = i->color.b;
+		wall.padding = 0;
+
+		worldWalls.push_back(wall);
+	}
+
+	Build(Point(config.world.w, config.world.h), config.world.chunkSize, worldWalls, SpawnArray());
+}
+
+void Level::Build(const Point worldSize, const unsigned long chunkSize, const WallArray& worldWalls,
+	const SpawnArray& worldSpawns)
+{
+	headerStorage.magic = Compiled::magic;
+	headerStorage.version = Compiled::version;
+	headerStorage.chunkSize = std::max<unsigned long>(chunkSize, 1);
+	headerStorage.columns = (std::max<Point::Coordinate>(worldSize.x, 0) + headerStorage.chunkSize - 1)
+		/ headerStorage.chunkSize;
+	headerStorage.rows = (std::max<Point::Coordinate>(worldSize.y, 0) + headerStorage.chunkSize - 1)
+		/ headerStorage.chunkSize;
+	headerStorage.padding = 0;
+	header = &headerStorage;
+
+	const Bounds world(Point(0, 0), worldSize);
+	const unsigned long chunkCount = headerStorage.columns * headerStorage.rows;
+
+	// the pieces of the walls in each chunk, in the order of the walls they're from
+	std::vector<WallArray> chunkWalls(chunkCount);
+	std::vector<Compiled::Index> overlapping;
+	for(WallArray::const_iterator i = worldWalls.begin(), end = worldWalls.end(); i != end; ++i)
+	{
+		overlapping.clear();
+		GetChunks(i->GetBounds(), overlapping);
+
+		for(std::vector<Compiled::Index>::const_iterator chunk = overlapping.begin(), chunksEnd = overlapping.end();
+			chunk != chunksEnd; ++chunk)
+		{
+			const Bounds chunkBounds = GetChunkBounds(*chunk);
+
+			Compiled::Wall piece = *i;
+			piece.minX = std::max(piece.minX, std::max(chunkBounds.min.x, world.min.x));
+			piece.minY = std::max(piece.minY, std::max(chunkBounds.min.y, world.min.y));
+			piece.maxX = std::min(piece.maxX, std::min(chunkBounds.max.x, world.max.x));
+			piece.maxY = std::min(piece.maxY, std::min(chunkBounds.max.y, world.max.y));
+
+			if(piece.minX < piece.maxX && piece.minY < piece.maxY)
+				chunkWalls[*chunk].push_back(piece);
+		}
+	}
+
+	std::vector<SpawnArray> chunkSpawns(chunkCount);
+	for(SpawnArray::const_iterator i = worldSpawns.begin(), end = worldSpawns.end(); i != end; ++i)
+	{
+		if(!i->GetBounds().Overlaps(world) || i->minX < 0 || i->minY < 0)
+			continue;
+
+		const unsigned long column = i->minX / headerStorage.chunkSize;
+		const unsigned long row = i->minY / headerStorage.chunkSize;
+		if(column < headerStorage.columns && row < headerStorage.rows)
+			chunkSpawns[column + row * headerStorage.columns].push_back(*i);
+	}
+
+	chunkStorage.resize(chunkCount);
+	for(unsigned long i = 0; i < chunkCount; ++i)
+	{
+		Compiled::Chunk& chunk = chunkStorage[i];
+		chunk.firstWall = wallStorage.size();
+		chunk.wallCount = chunkWalls[i].size();
+		chunk.firstSpawn = spawnStorage.size();
+		chunk.spawnCount = chunkSpawns[i].size();
+
+		wallStorage.insert(wallStorage.end(), chunkWalls[i].begin(), chunkWalls[i].end());
+		spawnStorage.insert(spawnStorage.end(), chunkSpawns[i].begin(), chunkSpawns[i].end());
+	}
+
+	headerStorage.wallCount = wallStorage.size();
+	headerStorage.spawnCount = spawnStorage.size();
+
+	chunks = chunkStorage.empty() ? NULL : &chunkStorage[0];
+	walls = wallStorage.empty() ? NULL : &wallStorage[0];
+	spawns = spawnStorage.empty() ? NULL : &spawnStorage[0];
+}
+
+static inline bool is_valid_range(const Level::Compiled::Index first, const Level::Compiled::Index count,
+	const Level::Compiled::Index size)
+{
+	return (first <= size && count <= size - first);
+}
+
+bool Level::Init(const char* const data, const unsigned long long size)
+{
+	if(size < sizeof(Compiled::Header))
+		return false;
+
+	header = reinterpret_cast<const Compiled::Header*>(data);
+	if(header->magic != Compiled::magic || header->version != Compiled::version || header->chunkSize == 0)
+		return false;
+
+	const unsigned long long chunkCount = static_cast<unsigned long long>(header->columns) * header->rows;
+	const unsigned long long expectedSize = sizeof(Compiled::Header)
+		+ chunkCount * sizeof(Compiled::Chunk)
+		+ static_cast<unsigned long long>(header->wallCount) * sizeof(Compiled::Wall)
+		+ static_cast<unsigned long long>(header->spawnCount) * sizeof(Compiled::Spawn);
+	if(size != expectedSize)
+		return false;
+
+	chunks = reinterpret_cast<const Compiled::Chunk*>(header + 1);
+	walls = reinterpret_cast<const Compiled::Wall*>(chunks + chunkCount);
+	spawns = reinterpret_cast<const Compiled::Spawn*>(walls + header->wallCount);
+
+	// check every range once here, so that they can be followed blindly afterwards
+	for(unsigned long long i = 0; i < chunkCount; ++i)
+		if(!is_valid_range(chunks[i].firstWall, chunks[i].wallCount, header->wallCount)
+			|| !is_valid_range(chunks[i].firstSpawn, chunks[i].spawnCount, header->spawnCount))
+			return false;
+
+	return true;
+}
+
+Level* Level::Map(const std::string& filename)
+{
+	std::auto_ptr<Level> level(new Level());
+
+	try
+	{
+		const boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+		level->region.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+	}
+	catch(const boost::interprocess::interprocess_exception& e)
+	{
+		LOGDEBUG(boost::format("Unable to map level \"%1%\": %2%") % filename % e.what())
+		return NULL;
+	}
+
+	if(!level->Init(static_cast<const char*>(level->region->get_address()), level->region->get_size()))
+	{
+		LOGDEBUG(boost::format("\"%1%\" is not a valid level (version %2%)") % filename
+			% static_cast<unsigned int>(Compiled::version))
+		return NULL;
+	}
+
+	return level.release();
+}
+
+void Level::Write(std::ostream& out) const
+{
+	out.write(reinterpret_cast<const char*>(header), sizeof(*header));
+	out.write(reinterpret_cast<const char*>(chunks), GetChunkCount() * sizeof(*chunks));
+	out.write(reinterpret_cast<const char*>(walls), header->wallCount * sizeof(*walls));
+	out.write(reinterpret_cast<const char*>(spawns), header->spawnCount * sizeof(*spawns));
+}
+
+unsigned long Level::GetChunkSize() const
+{
+	return header->chunkSize;
+}
+
+unsigned long Level::GetChunkCount() const
+{
+	return header->columns * header->rows;
+}
+
+unsigned long Level::GetWallCount() const
+{
+	return header->wallCount;
+}
+
+unsigned long Level::GetSpawnCount() const
+{
+	return header->spawnCount;
+}
+
+const Level::Compiled::Chunk& Level::GetChunk(const Compiled::Index chunk) const
+{
+	return chunks[chunk];
+}
+
+Bounds Level::GetChunkBounds(const Compiled::Index chunk) const
+{
+	const Point min((chunk % header->columns) * header->chunkSize, (chunk / header->columns) * header->chunkSize);
+
+	return Bounds(min, Point(min.x + header->chunkSize, min.y + header->chunkSize));
+}
+
+const Level::Compiled::Wall* Level::GetWalls() const
+{
+	return walls;
+}
+
+const Level::Compiled::Spawn* Level::GetSpawns() const
+{
+	return spawns;
+}
+
+bool Level::GetChunkRange(const Point::Coordinate min, const Point::Coordinate max, const unsigned long chunkCount,
+	unsigned long& first, unsigned long& last) const
+{
+	if(min >= max || max <= 0 || chunkCount == 0)
+		return false;
+
+	first = std::max<Point::Coordinate>(min, 0) / header->chunkSize;
+	if(first >= chunkCount)
+		return false;
+
+	last = std::min<unsigned long>((max - 1) / header->chunkSize, chunkCount - 1);
+	return true;
+}
+
+void Level::GetChunks(const Bounds& region, std::vector<Compiled::Index>& result) const
+{
+	unsigned long x0, x1, y0, y1;
+	if(!GetChunkRange(region.min.x, region.max.x, header->columns, x0, x1) ||
+		!GetChunkRange(region.min.y, region.max.y, header->rows, y0, y1))
+		return;
+
+	for(unsigned long y = y0; y <= y1; ++y)
+		for(unsigned long x = x0; x <= x1; ++x)
+			result.push_back(x + y * header->columns);
+}
+
+bool Level::AnyWall(const Bounds& bounds) const
+{
+	unsigned long x0, x1, y0, y1;
+	if(!GetChunkRange(bounds.min.x, bounds.max.x, header->columns, x0, x1) ||
+		!GetChunkRange(bounds.min.y, bounds.max.y, header->rows, y0, y1))
+		return false;
+
+	for(unsigned long y = y0; y <= y1; ++y)
+		for(unsigned long x = x0; x <= x1; ++x)
+		{
+			const Compiled::Chunk& chunk = chunks[x + y * header->columns];
+			for(const Compiled::Wall* wall = walls + chunk.firstWall, * const end = wall + chunk.wallCount;
+				wall != end; ++wall)
+				if(wall->GetBounds().Overlaps(bounds))
+					return true;
+		}
+
+	return false;
+}
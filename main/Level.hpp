@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Bounds.hpp"
+#include "Color24.hpp"
+#include "Point.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+struct Config;
+
+// The static parts of a world (walls, and spawns that are there from the start), chopped into square
+// chunks, so that the parts of the world near the snake can be used without the rest (see ChunkCache).
+// A level is either built in memory (from the walls in the config, or by a generator) or mapped in from
+// a level file, which has the same layout as a built level's records, so the chunks of a mapped level
+// are only read from disk once something uses them.
+// A file is laid out as: Header, Chunk[columns * rows], Wall[wallCount], Spawn[spawnCount]. Chunk
+// (x, y) is chunk x + y * columns, and covers [x * chunkSize, (x + 1) * chunkSize) by
+// [y * chunkSize, (y + 1) * chunkSize) of the world.
+class Level : private boost::noncopyable
+{
+public:
+	struct Compiled
+	{
+		typedef boost::uint32_t Index;
+
+		enum
+		{
+			magic = 0x4c564c53, // "SLVL"
+			// bump whenever the layout changes; files of other versions are rejected
+			version = 1
+		};
+
+		struct Header
+		{
+			Index magic;
+			Index version;
+			Index chunkSize;
+			Index columns;
+			Index rows;
+			Index wallCount;
+			Index spawnCount;
+			Index padding;
+		};
+
+		// the chunk's ranges of the wall and spawn arrays
+		struct Chunk
+		{
+			Index firstWall;
+			Index wallCount;
+			Index firstSpawn;
+			Index spawnCount;
+		};
+
+		struct Wall
+		{
+			boost::int32_t minX, minY, maxX, maxY;
+			Uint8 r, g, b;
+			Uint8 padding;
+
+			Bounds GetBounds() const;
+			Color24 GetColor() const;
+		};
+
+		// a food or mine which never expires. Mines have no effects.
+		struct Spawn
+		{
+			boost::int64_t pointChange;
+			double lengthFactor;
+			boost::int32_t minX, minY, maxX, maxY;
+			boost::int16_t speedChange;
+			// a WorldObject::ObjectType
+			Uint8 type;
+			Uint8 r, g, b;
+			Uint8 padding[2];
+
+			Bounds GetBounds() const;
+			Color24 GetColor() const;
+		};
+	};
+
+	typedef std::vector<Compiled::Wall> WallArray;
+	typedef std::vector<Compiled::Spawn> SpawnArray;
+
+private:
+	Compiled::Header headerStorage;
+	std::vector<Compiled::Chunk> chunkStorage;
+	WallArray wallStorage;
+	SpawnArray spawnStorage;
+
+	// backing storage for a mapped level
+	boost::shared_ptr<boost::interprocess::mapped_region> region;
+
+	const Compiled::Header* header;
+	const Compiled::Chunk* chunks;
+	const Compiled::Wall* walls;
+	const Compiled::Spawn* spawns;
+
+	Level();
+
+	// chop _worldWalls_ and _worldSpawns_ into chunks of _chunkSize_ over a _worldSize_ world
+	void Build(Point worldSize, unsigned long chunkSize, const WallArray& worldWalls,
+		const SpawnArray& worldSpawns);
+	// point the record arrays at _data_, returning false if it isn't a valid level
+	bool Init(const char* data, unsigned long long size);
+
+	// the range of chunks [_first_, _last_] along an axis which [_min_, _max_) touches, or false if none
+	bool GetChunkRange(Point::Coordinate min, Point::Coordinate max, unsigned long chunkCount,
+		unsigned long& first, unsigned long& last) const;
+
+public:
+	// Build a level over a _worldSize_ world from _worldWalls_ and _worldSpawns_ (in world coordinates).
+	// Walls are split along chunk boundaries, and spawns go in the chunk their top-left corner is in.
+	// Anything outside the world is left out.
+	Level(Point worldSize, unsigned long chunkSize, const WallArray& worldWalls, const SpawnArray& worldSpawns);
+	// build a level from the walls in _config_ (with no spawns)
+	explicit Level(const Config& config);
+
+	// map in a level file, returning NULL if _filename_ isn't a valid one
+	static Level* Map(const std::string& filename);
+	void Write(std::ostream& out) const;
+
+	unsigned long GetChunkSize() const;
+	unsigned long GetChunkCount() const;
+	unsigned long GetWallCount() const;
+	unsigned long GetSpawnCount() const;
+
+	const Compiled::Chunk& GetChunk(Compiled::Index chunk) const;
+	// the part of the world chunk _chunk_ covers
+	Bounds GetChunkBounds(Compiled::Index chunk) const;
+	// the whole wall and spawn arrays, which chunks index into
+	const Compiled::Wall* GetWalls() const;
+	const Compiled::Spawn* GetSpawns() const;
+
+	// append every chunk which overlaps _region_ to _result_, row by row
+	void GetChunks(const Bounds& region, std::vector<Compiled::Index>& result) const;
+	// returns true iff any wall overlaps _bounds_
+	bool AnyWall(const Bounds& bounds) const;
+};
+
+BOOST_STATIC_ASSERT(sizeof(Level::Compiled::Header) == 32);
+BOOST_STATIC_ASSERT(sizeof(Level::Compiled::Chunk) == 16);
+BOOST_STATIC_ASSERT(sizeof(Level::Compiled::Wall) == 20);
+BOOST_STATIC_ASSERT(sizeof(Level::Compiled::Spawn) == 40);
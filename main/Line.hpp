@@ -2,8 +2,6 @@
 
 #include "Point.hpp"
 
-struct Vector2D;
-
 // express a vertical or horizontal
 struct Line
 {
@@ -16,3 +14,17 @@ struct Line
 	Line& operator+=(Vector2D);
 	Line operator+(Vector2D) const;
 };
+
+inline Line Line::operator+(const Vector2D v) const
+{
+	Line newLine(*this);
+	newLine.min += v;
+
+	return newLine;
+}
+
+inline Line& Line::operator+=(const Vector2D v)
+{
+	min += v;
+	return *this;
+}
@@ -4,43 +4,348 @@
 #pragma warning(push, 0)
 #endif
 
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
+#include <string>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-static inline void write(const char* const type, const char* const message)
+// Every logging thread gets a fixed-size ring of records, which only it writes and only the writer
+// thread reads, so logging never takes a lock. A full ring drops (and counts) new records rather than
+// growing, so memory use is bounded by bufferRecords * sizeof(Record) per logging thread.
+static const unsigned long bufferRecords = 1024;
+static const unsigned long maxMessageLength = 240;
+// how long the writer sleeps when there's nothing to write (ms)
+static const unsigned long writerPeriod = 10;
+
+static const char* const levelNames[] = {"", "debug", "fatal"};
+
+struct Record
+{
+	// ms since logging started
+	boost::uint64_t time;
+	unsigned short level;
+	unsigned short length;
+	char message[maxMessageLength];
+};
+
+struct ThreadBuffer
+{
+	Record records[bufferRecords];
+	// _head_ is only written by the logging thread, and _tail_ only by the writer thread
+	boost::atomic<unsigned long> head;
+	boost::atomic<unsigned long> tail;
+	// records dropped because the ring was full, and how many of those have been reported
+	boost::atomic<unsigned long> dropped;
+	unsigned long droppedReported;
+
+	unsigned int id;
+	ThreadBuffer* next;
+
+	ThreadBuffer(const unsigned int _id) :
+		head(0), tail(0), dropped(0), droppedReported(0), id(_id), next(NULL)
+	{
+	}
+};
+
+// buffers outlive their threads, so that whatever they logged last still gets written
+static void keep_buffer(ThreadBuffer*)
 {
-	printf("[%s] %s\n", type, message);
 }
 
-namespace Logger
+class Sink
+{
+private:
+	boost::atomic<ThreadBuffer*> buffers;
+	boost::atomic<unsigned int> bufferCount;
+	boost::thread_specific_ptr<ThreadBuffer> currentBuffer;
+
+	// guards the output settings, which only change between batches
+	boost::mutex outputMutex;
+	FILE* output;
+	Logger::Format format;
+
+	boost::atomic<bool> quitting;
+	boost::thread writer;
+
+	const boost::posix_time::ptime start;
+
+	ThreadBuffer& GetThreadBuffer();
+	// the time since _start_, in ms
+	boost::uint64_t GetTime() const;
+
+	// write (and retire) everything in _buffer_, returning false if it was empty
+	bool Drain(ThreadBuffer& buffer, std::string& lines);
+	void Format(const ThreadBuffer& buffer, const Record& record, std::string& lines) const;
+	void WriteLoop();
+
+public:
+	Sink();
+	~Sink();
+
+	void Write(Logger::Level level, const char* message);
+	void Flush();
+	bool Open(const char* filename, Logger::Format format);
+	unsigned long GetDroppedCount() const;
+};
+
+Sink::Sink() :
+	buffers(NULL), bufferCount(0), currentBuffer(&keep_buffer), output(stdout), format(Logger::text), quitting(false),
+	start(boost::posix_time::microsec_clock::universal_time())
+{
+	writer = boost::thread(boost::bind(&Sink::WriteLoop, this));
+}
+
+Sink::~Sink()
 {
-#ifdef NDEBUG
-	void Debug(const char* const)
+	quitting = true;
+	writer.join();
+
+	if(output != stdout)
+		fclose(output);
+}
+
+boost::uint64_t Sink::GetTime() const
+{
+	return (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds();
+}
+
+ThreadBuffer& Sink::GetThreadBuffer()
+{
+	ThreadBuffer* buffer = currentBuffer.get();
+	if(buffer == NULL)
+	{
+		buffer = new ThreadBuffer(bufferCount++);
+		currentBuffer.reset(buffer);
+
+		// push onto the list of all buffers
+		buffer->next = buffers.load();
+		while(!buffers.compare_exchange_weak(buffer->next, buffer))
+		{
+		}
+	}
+
+	return *buffer;
+}
+
+void Sink::Write(const Logger::Level level, const char* const message)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	const unsigned long head = buffer.head.load(boost::memory_order_relaxed);
+	if(head - buffer.tail.load(boost::memory_order_acquire) >= bufferRecords)
 	{
+		buffer.dropped.store(buffer.dropped.load(boost::memory_order_relaxed) + 1, boost::memory_order_relaxed);
+		return;
 	}
 
-	void Debug(const boost::format&)
+	Record& record = buffer.records[head % bufferRecords];
+	record.time = GetTime();
+	record.level = level;
+	record.length = std::min<unsigned long>(strlen(message), maxMessageLength);
+	memcpy(record.message, message, record.length);
+
+	buffer.head.store(head + 1, boost::memory_order_release);
+}
+
+// append _str_ to _lines_ as a JSON string
+static void append_json_string(std::string& lines, const char* const str, const unsigned long length)
+{
+	lines += '"';
+	for(unsigned long i = 0; i < length; ++i)
 	{
+		const char c = str[i];
+		if(c == '"' || c == '\\')
+		{
+			lines += '\\';
+			lines += c;
+		}
+		else if(static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[8];
+			sprintf(escaped, "\\u%04x", static_cast<unsigned int>(c));
+			lines += escaped;
+		}
+		else
+			lines += c;
 	}
-#else
+	lines += '"';
+}
+
+template <typename _T>
+static inline void append_binary(std::string& lines, const _T value)
+{
+	lines.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void Sink::Format(const ThreadBuffer& buffer, const Record& record, std::string& lines) const
+{
+	char prefix[128];
+
+	switch(format)
+	{
+		case Logger::text:
+			sprintf(prefix, "[%s %llu #%u] ", levelNames[record.level],
+				static_cast<unsigned long long>(record.time), buffer.id);
+			lines += prefix;
+			lines.append(record.message, record.length);
+			lines += '\n';
+			break;
+
+		case Logger::jsonLines:
+			sprintf(prefix, "{\"time\":%llu,\"thread\":%u,\"level\":\"%s\",\"message\":",
+				static_cast<unsigned long long>(record.time), buffer.id, levelNames[record.level]);
+			lines += prefix;
+			append_json_string(lines, record.message, record.length);
+			lines += "}\n";
+			break;
+
+		case Logger::binary:
+			append_binary<boost::uint64_t>(lines, record.time);
+			append_binary<boost::uint32_t>(lines, buffer.id);
+			append_binary<boost::uint16_t>(lines, record.level);
+			append_binary<boost::uint16_t>(lines, record.length);
+			lines.append(record.message, record.length);
+			break;
+	}
+}
+
+bool Sink::Drain(ThreadBuffer& buffer, std::string& lines)
+{
+	const unsigned long tail = buffer.tail.load(boost::memory_order_relaxed);
+	const unsigned long head = buffer.head.load(boost::memory_order_acquire);
+
+	for(unsigned long i = tail; i != head; ++i)
+		Format(buffer, buffer.records[i % bufferRecords], lines);
+
+	// anything dropped was dropped after the records which filled the buffer
+	const unsigned long dropped = buffer.dropped.load(boost::memory_order_relaxed);
+	if(dropped != buffer.droppedReported)
+	{
+		Record record;
+		record.time = GetTime();
+		record.level = Logger::debug;
+		record.length = sprintf(record.message, "dropped %lu messages (log buffer full)", dropped - buffer.droppedReported);
+		buffer.droppedReported = dropped;
+
+		Format(buffer, record, lines);
+	}
+
+	if(lines.empty())
+		return false;
+
+	fwrite(lines.data(), 1, lines.size(), output);
+	fflush(output);
+	lines.clear();
+
+	// only give the records back once they're written, so that Flush() can tell when they are
+	buffer.tail.store(head, boost::memory_order_release);
+	return true;
+}
+
+void Sink::WriteLoop()
+{
+	std::string lines;
+
+	while(true)
+	{
+		// read before draining, so that nothing logged before quitting gets left behind
+		const bool quit = quitting;
+
+		bool wroteAny = false;
+		{
+			const boost::mutex::scoped_lock lock(outputMutex);
+			for(ThreadBuffer* buffer = buffers.load(); buffer != NULL; buffer = buffer->next)
+				wroteAny |= Drain(*buffer, lines);
+		}
+
+		if(quit)
+			return;
+
+		if(!wroteAny)
+			boost::this_thread::sleep(boost::posix_time::milliseconds(writerPeriod));
+	}
+}
+
+void Sink::Flush()
+{
+	for(ThreadBuffer* buffer = buffers.load(); buffer != NULL; buffer = buffer->next)
+	{
+		const unsigned long head = buffer->head.load(boost::memory_order_acquire);
+		while(buffer->tail.load(boost::memory_order_acquire) < head)
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+	}
+}
+
+bool Sink::Open(const char* const filename, const Logger::Format _format)
+{
+	FILE* const file = fopen(filename, (_format == Logger::binary) ? "wb" : "w");
+	if(file == NULL)
+		return false;
+
+	Flush();
+
+	const boost::mutex::scoped_lock lock(outputMutex);
+	if(output != stdout)
+		fclose(output);
+
+	output = file;
+	format = _format;
+
+	if(format == Logger::binary)
+	{
+		std::string header("SNKL");
+		append_binary<boost::uint32_t>(header, 1);
+		fwrite(header.data(), 1, header.size(), output);
+	}
+
+	return true;
+}
+
+unsigned long Sink::GetDroppedCount() const
+{
+	unsigned long dropped = 0;
+	for(const ThreadBuffer* buffer = buffers.load(); buffer != NULL; buffer = buffer->next)
+		dropped += buffer->dropped.load(boost::memory_order_relaxed);
+
+	return dropped;
+}
+
+static Sink& get_sink()
+{
+	static Sink sink;
+	return sink;
+}
+
+namespace Logger
+{
 	void Debug(const char* const message)
 	{
-		write("Debug", message);
+		get_sink().Write(debug, message);
 	}
 
 	void Debug(const boost::format& message)
 	{
 		return Debug(message.str().c_str());
 	}
-#endif
 
 	void Fatal(const char* const message)
 	{
-		write("Fatal", message);
+		// make sure this is the last thing written before dying (and that there's room for it)
+		get_sink().Flush();
+		get_sink().Write(fatal, message);
+		get_sink().Flush();
 		throw std::runtime_error(message);
 	}
 
@@ -48,4 +353,19 @@ namespace Logger
 	{
 		return Fatal(message.str().c_str());
 	}
+
+	void Flush()
+	{
+		get_sink().Flush();
+	}
+
+	bool Open(const char* const filename, const Format format)
+	{
+		return get_sink().Open(filename, format);
+	}
+
+	unsigned long GetDroppedCount()
+	{
+		return get_sink().GetDroppedCount();
+	}
 }
@@ -10,8 +10,37 @@
 #pragma warning(pop)
 #endif
 
+// log levels; messages below LOGLEVEL are compiled out
+#define LOGLEVEL_DEBUG 1
+#define LOGLEVEL_FATAL 2
+
+#ifndef LOGLEVEL
+#ifdef NDEBUG
+#define LOGLEVEL LOGLEVEL_FATAL
+#else
+#define LOGLEVEL LOGLEVEL_DEBUG
+#endif
+#endif
+
 namespace Logger
 {
+	enum Level
+	{
+		debug = LOGLEVEL_DEBUG,
+		fatal = LOGLEVEL_FATAL
+	};
+
+	// Output formats. Every line/record has the time (in ms since logging started), the logging
+	// thread's (sequential) id, the level and the message. Binary files start with "SNKL"
+	// and a uint32 version (1), then each record is a uint64 time, uint32 thread id,
+	// uint16 level, uint16 message length and the message, in native byte order.
+	enum Format
+	{
+		text,
+		jsonLines,
+		binary
+	};
+
 	// log debug output
 	void Debug(const char* const message);
 	void Debug(const boost::format& message);
@@ -19,4 +48,22 @@ namespace Logger
 	// log fatal errors
 	void Fatal(const char* const message);
 	void Fatal(const boost::format& message);
+
+	// wait for everything logged so far to be written out
+	void Flush();
+
+	// write the log to _filename_ in _format_ from now on (instead of to stdout, as text),
+	// returning false if it couldn't be opened
+	bool Open(const char* filename, Format format);
+
+	// get the number of messages dropped so far because a thread's log buffer was full
+	unsigned long GetDroppedCount();
 }
+
+// Log debug output. When debug logging is compiled out, _message_ isn't even
+// evaluated, so it can be as expensive (e.g. a boost::format) as it needs to be.
+#if LOGLEVEL <= LOGLEVEL_DEBUG
+#define LOGDEBUG(message) Logger::Debug(message);
+#else
+#define LOGDEBUG(message) ((void)0);
+#endif
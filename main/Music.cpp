@@ -1,6 +1,5 @@
 #include "Music.hpp"
 
-#include "Config.hpp"
 #include "Logger.hpp"
 
 #ifdef MSVC
@@ -20,18 +19,13 @@ Music::Music()
 
 Music::Music(const std::string& filename)
 {
-	if(Config::Get().music)
-	{
-		music = Mix_LoadMUS(filename.c_str());
+	music = Mix_LoadMUS(filename.c_str());
 
-		if(music == NULL)
-			Logger::Debug(boost::format("Error playing music \"%1%\": %2%")
-				% filename.c_str() % Mix_GetError());
-		else
-			Mix_PlayMusic(music, -1);
-	}
+	if(music == NULL)
+		LOGDEBUG(boost::format("Error playing music \"%1%\": %2%")
+			% filename.c_str() % Mix_GetError())
 	else
-		music = NULL;
+		Mix_PlayMusic(music, -1);
 }
 
 Music::Music(Music& obj)
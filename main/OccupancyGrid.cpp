@@ -0,0 +1,136 @@
+#include "OccupancyGrid.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+static const unsigned long wordBits = 64;
+
+static inline unsigned long get_word_count(const unsigned long bits)
+{
+	return (bits + wordBits - 1) / wordBits;
+}
+
+// the bits of a word from _begin_ up to (but not including) _end_, where 0 <= _begin_ < _end_ <= 64
+static inline OccupancyGrid::Word get_mask(const unsigned long begin, const unsigned long end)
+{
+	const OccupancyGrid::Word all = ~static_cast<OccupancyGrid::Word>(0);
+	return (all << begin) & (all >> (wordBits - end));
+}
+
+// set or clear bits _begin_ up to _end_ of _words_
+static void fill_span(OccupancyGrid::Word* const words, const unsigned long begin, const unsigned long end,
+	const bool set)
+{
+	for(unsigned long bit = begin; bit < end;)
+	{
+		const unsigned long word = bit / wordBits;
+		const unsigned long spanEnd = std::min(end, (word + 1) * wordBits);
+		const OccupancyGrid::Word mask = get_mask(bit % wordBits, spanEnd - word * wordBits);
+
+		if(set)
+			words[word] |= mask;
+		else
+			words[word] &= ~mask;
+
+		bit = spanEnd;
+	}
+}
+
+// returns true iff any of bits _begin_ up to _end_ of _words_ are set
+static bool any_in_span(const OccupancyGrid::Word* const words, const unsigned long begin, const unsigned long end)
+{
+	for(unsigned long bit = begin; bit < end;)
+	{
+		const unsigned long word = bit / wordBits;
+		const unsigned long spanEnd = std::min(end, (word + 1) * wordBits);
+
+		if(words[word] & get_mask(bit % wordBits, spanEnd - word * wordBits))
+			return true;
+
+		bit = spanEnd;
+	}
+
+	return false;
+}
+
+OccupancyGrid::OccupancyGrid(const unsigned long _width, const unsigned long _height)
+{
+	Resize(_width, _height);
+}
+
+void OccupancyGrid::Resize(const unsigned long _width, const unsigned long _height)
+{
+	width = _width;
+	height = _height;
+	rowWords = get_word_count(width);
+	columnWords = get_word_count(height);
+
+	rows.assign(rowWords * height, 0);
+	columns.assign(columnWords * width, 0);
+}
+
+void OccupancyGrid::Clear()
+{
+	std::fill(rows.begin(), rows.end(), 0);
+	std::fill(columns.begin(), columns.end(), 0);
+}
+
+void OccupancyGrid::Fill(const Bounds& bounds, const bool occupied)
+{
+	const long minX = std::max<long>(bounds.min.x, 0);
+	const long minY = std::max<long>(bounds.min.y, 0);
+	const long maxX = std::min<long>(bounds.max.x, width);
+	const long maxY = std::min<long>(bounds.max.y, height);
+
+	if(minX >= maxX || minY >= maxY)
+		return;
+
+	for(long y = minY; y < maxY; ++y)
+		fill_span(&rows[y * rowWords], minX, maxX, occupied);
+
+	for(long x = minX; x < maxX; ++x)
+		fill_span(&columns[x * columnWords], minY, maxY, occupied);
+}
+
+void OccupancyGrid::Set(const Bounds& bounds)
+{
+	Fill(bounds, true);
+}
+
+void OccupancyGrid::Unset(const Bounds& bounds)
+{
+	Fill(bounds, false);
+}
+
+bool OccupancyGrid::Any(const Bounds& bounds) const
+{
+	if(bounds.min.x >= bounds.max.x || bounds.min.y >= bounds.max.y)
+		return false;
+
+	if(bounds.min.x < 0 || bounds.min.y < 0 ||
+		bounds.max.x > static_cast<long>(width) || bounds.max.y > static_cast<long>(height))
+		return true;
+
+	// test whichever way round is fewer runs of bits
+	if(bounds.max.y - bounds.min.y <= bounds.max.x - bounds.min.x)
+	{
+		for(long y = bounds.min.y; y < bounds.max.y; ++y)
+			if(any_in_span(&rows[y * rowWords], bounds.min.x, bounds.max.x))
+				return true;
+	}
+	else
+	{
+		for(long x = bounds.min.x; x < bounds.max.x; ++x)
+			if(any_in_span(&columns[x * columnWords], bounds.min.y, bounds.max.y))
+				return true;
+	}
+
+	return false;
+}
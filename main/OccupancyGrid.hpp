@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Bounds.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// one bit per pixel of the world, set where there's a wall or a piece of snake, so that whether a
+// line of pixels is clear can be tested a word at a time. It's kept both row-major and transposed,
+// so that horizontal and vertical lines are both contiguous runs of bits.
+// Anything off the grid counts as occupied.
+class OccupancyGrid
+{
+public:
+	typedef boost::uint64_t Word;
+
+private:
+	unsigned long width, height;
+	// words per row of _rows_, and per column of _columns_
+	unsigned long rowWords, columnWords;
+	// bit x of row y is pixel (x, y)
+	std::vector<Word> rows;
+	// bit y of column x is pixel (x, y)
+	std::vector<Word> columns;
+
+	// set or clear every pixel of _bounds_ which is on the grid
+	void Fill(const Bounds& bounds, bool occupied);
+
+public:
+	OccupancyGrid(unsigned long width, unsigned long height);
+
+	// resize to _width_ by _height_, and clear
+	void Resize(unsigned long width, unsigned long height);
+	void Clear();
+
+	void Set(const Bounds& bounds);
+	void Unset(const Bounds& bounds);
+	// returns true iff any pixel of _bounds_ is occupied
+	bool Any(const Bounds& bounds) const;
+};
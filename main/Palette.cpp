@@ -0,0 +1,114 @@
+#include "Palette.hpp"
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "Mutex.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Palette
+{
+	// open-addressed, at most half full
+	static const unsigned int tableSize = 2 * maxColors;
+
+	static Color24 colors[maxColors];
+	// colors below this are in use, and never change (guarded by _addMutex_)
+	static unsigned int colorCount = 0;
+	// each color's index plus one, by hash of the color (or 0 for an empty slot). Slots are only ever
+	// filled, after the color itself is written.
+	static boost::atomic<boost::uint32_t> table[tableSize];
+	// whether running out of colors has been logged yet (guarded by _addMutex_)
+	static bool loggedFull = false;
+	// held while adding colors
+	static Mutex addMutex;
+
+	static inline bool same_color(const Color24 color1, const Color24 color2)
+	{
+		return (color1.r == color2.r && color1.g == color2.g && color1.b == color2.b);
+	}
+
+	static inline unsigned int get_slot(const Color24 color)
+	{
+		const boost::uint32_t rgb = (color.r << 16) | (color.g << 8) | color.b;
+		return (rgb * 2654435761u) % tableSize;
+	}
+
+	// the slot holding _color_, or the empty slot it would go in
+	static inline unsigned int find_slot(const Color24 color)
+	{
+		unsigned int slot = get_slot(color);
+		for(;;)
+		{
+			const unsigned int entry = table[slot].load(boost::memory_order_acquire);
+			if(entry == 0 || same_color(colors[entry - 1], color))
+				return slot;
+
+			slot = (slot + 1) % tableSize;
+		}
+	}
+
+	// the index of the color closest to _color_
+	static Index find_closest(const Color24 color)
+	{
+		unsigned int closest = 0;
+		long closestDistance = -1;
+		for(unsigned int i = 0; i < maxColors; ++i)
+		{
+			const long r = colors[i].r - color.r, g = colors[i].g - color.g, b = colors[i].b - color.b;
+			const long distance = r * r + g * g + b * b;
+			if(closestDistance < 0 || distance < closestDistance)
+			{
+				closest = i;
+				closestDistance = distance;
+			}
+		}
+
+		return closest;
+	}
+
+	Index GetIndex(const Color24 color)
+	{
+		unsigned int entry = table[find_slot(color)].load(boost::memory_order_acquire);
+		if(entry != 0)
+			return entry - 1;
+
+		DOLOCKED(addMutex,
+			// it may have been added in the meantime
+			const unsigned int slot = find_slot(color);
+			entry = table[slot].load(boost::memory_order_relaxed);
+			if(entry == 0)
+			{
+				if(colorCount < maxColors)
+				{
+					colors[colorCount] = color;
+					entry = ++colorCount;
+					table[slot].store(entry, boost::memory_order_release);
+				}
+				else
+				{
+					if(!loggedFull)
+						LOGDEBUG(boost::format("More than %1% different colors used; using the closest ones instead") % maxColors)
+					loggedFull = true;
+
+					entry = find_closest(color) + 1;
+				}
+			}
+		)
+
+		return entry - 1;
+	}
+
+	Color24 GetColor(const Index index)
+	{
+		return colors[index];
+	}
+}
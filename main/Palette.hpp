@@ -0,0 +1,28 @@
+#pragma once
+// Every color any world object has been given, so that objects can store a two-byte index instead
+// of a color. Colors are only ever added, and there can be at most _maxColors_ of them; past that,
+// new colors get the index of the closest color there is.
+// Can be used from any thread.
+
+#include "Color24.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <SDL_types.h>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Palette
+{
+	typedef Uint16 Index;
+
+	static const unsigned int maxColors = 65536;
+
+	// get the index of _color_, adding it if it's new
+	Index GetIndex(Color24 color);
+	Color24 GetColor(Index index);
+}
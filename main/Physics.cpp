@@ -3,27 +3,16 @@
 #include "Bounds.hpp"
 #include "Common.hpp"
 #include "collision.h"
-#include "GameWorld.hpp"
+#include "Profiler.hpp"
 #include "UniqueObjectCollection.hpp"
-
-#ifdef MSVC
-#pragma warning(push, 0)
-#endif
-
-#include <algorithm>
-#include <boost/bind.hpp>
-
-#ifdef MSVC
-#pragma warning(pop)
-#endif
+#include "WorldObject.hpp"
 
 namespace Physics
 {
-	static inline ObjectBounds get_world_object_bounds(const WorldObject* const w)
+	static inline ObjectBounds get_object_bounds(const Bounds& bounds)
 	{
 		ObjectBounds ret;
 
-		const Bounds bounds = w->GetBounds();
 		ret.min.x = bounds.min.x;
 		ret.min.y = bounds.min.y;
 		ret.max.x = bounds.max.x;
@@ -32,51 +21,51 @@ namespace Physics
 		return ret;
 	}
 
-	static inline bool does_collide(const WorldObject& o1, const WorldObject& o2)
-	{
-		DOLOCKED(o1.mutex,
-			const ObjectBounds c1 = get_world_object_bounds(&o1);
-		)
-		DOLOCKED(o2.mutex,
-			const ObjectBounds c2 = get_world_object_bounds(&o2);
-		)
-
-		return does_collide(&c1, &c2) != 0;
-	}
-	
-	static void handle_potential_collision(GameWorld* const world, WorldObject* const o1,
-		WorldObject* const o2)
+	static inline ObjectBounds get_world_object_bounds(const WorldObject* const w)
 	{
-		if(does_collide(*o1, *o2))
-			world->CollisionHandler(*o1, *o2);
+		return get_object_bounds(w->GetBounds());
 	}
 
-	static inline void collide_with_subsequent_objects(GameWorld* const world,
-		const UniqueObjectCollection::const_iterator collider, const UniqueObjectCollection::const_iterator end)
+	static inline bool does_collide(const Bounds& b1, const Bounds& b2)
 	{
-		for_each(collider + 1, end, bind(&handle_potential_collision, world, *collider, _1));
+		const ObjectBounds c1 = get_object_bounds(b1);
+		const ObjectBounds c2 = get_object_bounds(b2);
+
+		return does_collide(&c1, &c2) != 0;
 	}
 
-	void Update(GameWorld& world, const UniqueObjectCollection& realPhysicsObjects)
+	void Update(const UniqueObjectCollection& physicsObjects, const EntityStore& entities,
+		EntityCollisionQueue& collisions, const unsigned long objectTypes)
 	{
-		if(realPhysicsObjects.begin() == realPhysicsObjects.end())
+		PROFILESCOPE(physicsUpdate)
+
+		const EntityStore::BoundsArray& entityBounds = entities.GetBounds();
+		if(entityBounds.empty())
 			return;
 
-		const UniqueObjectCollection physicsObjects(realPhysicsObjects);
+		for(UniqueObjectCollection::const_iterator collider = physicsObjects.begin(), end = physicsObjects.end();
+			collider != end; ++collider)
+		{
+			if(((*collider)->GetObjectType() & objectTypes) == 0)
+				continue;
 
-		// don't try the last gameObject, since all have been checked against it
-		for(UniqueObjectCollection::const_iterator collider = physicsObjects.begin(),
-			end = physicsObjects.end() - 1; collider != end; ++collider)
-			collide_with_subsequent_objects(&world, collider, physicsObjects.end());
+			const ObjectBounds c1 = get_world_object_bounds(*collider);
+			for(EntityStore::Index i = 0, count = entityBounds.size(); i < count; ++i)
+			{
+				const ObjectBounds c2 = get_object_bounds(entityBounds[i]);
+				if(does_collide(&c1, &c2))
+					collisions.push_back(EntityCollision(*collider, entities.GetID(i)));
+			}
+		}
 	}
 
-	bool AnyCollide(const WorldObject& obj, const UniqueObjectCollection& physicsObjects)
+	bool AnyCollide(const Bounds& bounds, const UniqueObjectCollection& physicsObjects)
 	{
 		DOLOCKED(physicsObjects.mutex,
 			for(UniqueObjectCollection::const_iterator collider = physicsObjects.begin(),
 				end = physicsObjects.end(); collider != end; ++collider)
 			{
-				if(does_collide(obj, **collider))
+				if(does_collide(bounds, (*collider)->GetBounds()))
 				{
 					physicsObjects.mutex.Unlock();
 					return true;
@@ -86,4 +75,14 @@ namespace Physics
 
 		return false;
 	}
+
+	bool AnyCollide(const Bounds& bounds, const EntityStore& entities)
+	{
+		const EntityStore::BoundsArray& entityBounds = entities.GetBounds();
+		for(EntityStore::BoundsArray::const_iterator i = entityBounds.begin(), end = entityBounds.end(); i != end; ++i)
+			if(does_collide(bounds, *i))
+				return true;
+
+		return false;
+	}
 }
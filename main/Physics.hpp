@@ -1,11 +1,35 @@
-class GameWorld;
+#pragma once
+
+#include "EntityStore.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <utility>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+struct Bounds;
 class UniqueObjectCollection;
 class WorldObject;
 
 namespace Physics
 {
-	// check all of _physicsObjects_ for collisions, and call respective collision handlers
-	void Update(GameWorld& gameWorld, const UniqueObjectCollection& physicsObjects);
-	// check if _obj_ collides with anything in _physicsObjects_
-	bool AnyCollide(const WorldObject& obj, const UniqueObjectCollection& physicsObjects);
+	// an object overlapping an entity
+	typedef std::pair<WorldObject*, EntityStore::ID> EntityCollision;
+	// the collisions found in one physics pass, to be resolved after the pass is done
+	typedef std::vector<EntityCollision> EntityCollisionQueue;
+
+	// check the objects in _physicsObjects_ whose types are in _objectTypes_ (a mask of
+	// WorldObject::ObjectType) against every entity, and append the overlaps to _collisions_
+	void Update(const UniqueObjectCollection& physicsObjects, const EntityStore& entities,
+		EntityCollisionQueue& collisions, unsigned long objectTypes);
+	// check if _bounds_ collides with anything in _physicsObjects_
+	bool AnyCollide(const Bounds& bounds, const UniqueObjectCollection& physicsObjects);
+	// check if _bounds_ collides with any entity
+	bool AnyCollide(const Bounds& bounds, const EntityStore& entities);
 }
@@ -0,0 +1,223 @@
+#include "Profiler.hpp"
+
+#ifdef INSTRUMENTED
+
+#include "Logger.hpp"
+#include "Tracer.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdio>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Profiler
+{
+	static const char* const sectionNames[sectionCount] = {
+		"snakeUpdate",
+		"physicsUpdate",
+		"spawnLoop",
+		"graphicsUpdate",
+		"soundPump",
+		"collisionResolve",
+		"eventPump",
+		"chunkUpdate",
+		"graphicsLockWait",
+		"physicsLockWait",
+		"eventHandlerLockWait",
+		"soundLockWait"
+	};
+
+	TimeType Now()
+	{
+		static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+	}
+
+	const char* GetSectionName(const Section section)
+	{
+		return sectionNames[section];
+	}
+
+	ScopedTimer::ScopedTimer(const Section _section)
+	{
+		section = _section;
+		start = Now();
+	}
+
+	ScopedTimer::~ScopedTimer()
+	{
+		Record(section, start, Now() - start);
+	}
+
+#ifdef PROFILING
+	// samples are bucketed by powers of 2; bucket i holds durations in [2^(i - 1), 2^i)
+	static const unsigned int bucketCount = 32;
+	// minimum time between DumpIfDue() dumps
+	static const TimeType dumpPeriod = 10 * 1000 * 1000;
+
+	// each counter has exactly one writer (its thread), so it can be
+	// updated without a read-modify-write, and read from anywhere
+	typedef boost::atomic<TimeType> Counter;
+
+	static inline void set(Counter& counter, const TimeType value)
+	{
+		counter.store(value, boost::memory_order_relaxed);
+	}
+
+	static inline TimeType get(const Counter& counter)
+	{
+		return counter.load(boost::memory_order_relaxed);
+	}
+
+	struct Histogram
+	{
+		Counter count, total, max;
+		Counter buckets[bucketCount];
+
+		Histogram()
+		{
+			set(count, 0);
+			set(total, 0);
+			set(max, 0);
+			for(unsigned int i = 0; i < bucketCount; ++i)
+				set(buckets[i], 0);
+		}
+	};
+
+	// the samples taken by one thread
+	struct ThreadBuffer
+	{
+		Histogram histograms[sectionCount];
+		boost::atomic<const char*> name;
+		ThreadBuffer* next;
+
+		ThreadBuffer() :
+			name("unnamed"), next(NULL)
+		{
+		}
+	};
+
+	// buffers outlive their threads, so that they can still be dumped
+	static void keep_buffer(ThreadBuffer*)
+	{
+	}
+
+	static boost::atomic<ThreadBuffer*> threadBuffers(NULL);
+	static boost::thread_specific_ptr<ThreadBuffer> currentBuffer(&keep_buffer);
+	static boost::atomic<TimeType> lastDump(0);
+
+	static ThreadBuffer& get_thread_buffer()
+	{
+		ThreadBuffer* buffer = currentBuffer.get();
+		if(buffer == NULL)
+		{
+			buffer = new ThreadBuffer();
+			currentBuffer.reset(buffer);
+
+			// push onto the list of all buffers
+			buffer->next = threadBuffers.load();
+			while(!threadBuffers.compare_exchange_weak(buffer->next, buffer))
+			{
+			}
+		}
+
+		return *buffer;
+	}
+
+	static inline unsigned int get_bucket(TimeType duration)
+	{
+		unsigned int bucket = 0;
+		for(; duration > 0 && bucket < bucketCount - 1; duration >>= 1)
+			++bucket;
+
+		return bucket;
+	}
+
+	static void record_histogram(const Section section, const TimeType duration)
+	{
+		Histogram& histogram = get_thread_buffer().histograms[section];
+
+		set(histogram.count, get(histogram.count) + 1);
+		set(histogram.total, get(histogram.total) + duration);
+		if(duration > get(histogram.max))
+			set(histogram.max, duration);
+
+		Counter& bucket = histogram.buckets[get_bucket(duration)];
+		set(bucket, get(bucket) + 1);
+	}
+
+	static void dump_histogram(FILE* const file, const char* const threadName, const Section section,
+		const Histogram& histogram)
+	{
+		const unsigned long long count = get(histogram.count);
+		if(count == 0)
+			return;
+
+		const unsigned long long total = get(histogram.total);
+		fprintf(file, "%s %s %llu %llu %llu %llu", threadName, sectionNames[section], count, total,
+			total / count, static_cast<unsigned long long>(get(histogram.max)));
+
+		for(unsigned int i = 0; i < bucketCount; ++i)
+			fprintf(file, " %llu", static_cast<unsigned long long>(get(histogram.buckets[i])));
+
+		fprintf(file, "\n");
+	}
+
+	void Dump(const char* const filename)
+	{
+		FILE* const file = fopen(filename, "w");
+		if(file == NULL)
+		{
+			LOGDEBUG(boost::format("Unable to open profile dump \"%1%\"") % filename)
+			return;
+		}
+
+		fprintf(file, "# thread section count total(us) mean(us) max(us) buckets(<1us, <2us, <4us, ...)\n");
+		for(const ThreadBuffer* buffer = threadBuffers.load(); buffer != NULL; buffer = buffer->next)
+			for(unsigned int section = 0; section < sectionCount; ++section)
+				dump_histogram(file, buffer->name, static_cast<Section>(section), buffer->histograms[section]);
+
+		fclose(file);
+	}
+
+	void DumpIfDue(const char* const filename)
+	{
+		const TimeType now = Now();
+		TimeType last = lastDump.load();
+
+		if(now - last >= dumpPeriod && lastDump.compare_exchange_strong(last, now))
+			Dump(filename);
+	}
+
+#endif
+
+	void NameThread(const char* const name)
+	{
+#ifdef PROFILING
+		get_thread_buffer().name = name;
+#endif
+#ifdef TRACING
+		Tracer::NameThread(name);
+#endif
+	}
+
+	void Record(const Section section, const TimeType start, const TimeType duration)
+	{
+#ifdef PROFILING
+		record_histogram(section, duration);
+#endif
+#ifdef TRACING
+		Tracer::Record(section, start, duration);
+#endif
+	}
+}
+
+#endif
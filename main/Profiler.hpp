@@ -0,0 +1,112 @@
+#pragma once
+// Per-tick timing instrumentation. PROFILING collects per-thread histograms, and TRACING
+// collects a timeline (see Tracer.hpp). Unless either is defined, all of the macros
+// below expand to nothing (or to a plain lock), and none of this is compiled in.
+
+#if defined(PROFILING) || defined(TRACING)
+#define INSTRUMENTED
+#endif
+
+#ifdef INSTRUMENTED
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Profiler
+{
+	// the instrumented sections of code
+	enum Section
+	{
+		snakeUpdate,
+		physicsUpdate,
+		spawnLoop,
+		graphicsUpdate,
+		soundPump,
+		collisionResolve,
+		eventPump,
+		chunkUpdate,
+
+		// time spent waiting to acquire the major mutexes
+		graphicsLockWait,
+		physicsLockWait,
+		eventHandlerLockWait,
+		soundLockWait,
+
+		sectionCount
+	};
+
+	// microseconds
+	typedef boost::uint64_t TimeType;
+
+	// get the current (wall) time
+	TimeType Now();
+
+	const char* GetSectionName(Section section);
+
+	// name the calling thread in the dumps
+	void NameThread(const char* name);
+
+	// add a sample of _section_, which started at _start_ and took _duration_, for the calling thread
+	void Record(Section section, TimeType start, TimeType duration);
+
+#ifdef PROFILING
+	// write every thread's histograms to _filename_
+	void Dump(const char* filename);
+	// Dump(), if it hasn't been done in the last few seconds
+	void DumpIfDue(const char* filename);
+#endif
+
+	// lock _mutex_, recording the time spent waiting for it in _section_
+	template <typename MutexType>
+	inline void Lock(const Section section, const MutexType& mutex)
+	{
+		const TimeType start = Now();
+		mutex.Lock();
+		Record(section, start, Now() - start);
+	}
+
+	// records its own lifetime in a section
+	class ScopedTimer
+	{
+	private:
+		Section section;
+		TimeType start;
+
+	public:
+		ScopedTimer(Section section);
+		~ScopedTimer();
+	};
+}
+
+#define PROFILESCOPE(section) const Profiler::ScopedTimer profileScopedTimer(Profiler::section);
+#define PROFILETHREAD(name) Profiler::NameThread(name);
+#define PROFILEDLOCK(section, mutex) Profiler::Lock(Profiler::section, mutex);
+
+#else
+
+#define PROFILESCOPE(section)
+#define PROFILETHREAD(name)
+#define PROFILEDLOCK(section, mutex) mutex.Lock();
+
+#endif
+
+#ifdef PROFILING
+#define PROFILEDUMP(filename) Profiler::Dump(filename);
+#define PROFILEDUMPIFDUE(filename) Profiler::DumpIfDue(filename);
+#else
+#define PROFILEDUMP(filename)
+#define PROFILEDUMPIFDUE(filename)
+#endif
+
+// like DOLOCKED, but the time spent waiting for _mutex_ is recorded in _section_
+#define DOLOCKEDP(section, mutex, thingsToDo) \
+	PROFILEDLOCK(section, mutex) \
+	thingsToDo \
+	mutex.Unlock();
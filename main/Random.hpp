@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/random/linear_congruential.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// the game's random number generator. Each game world owns one, seeded once,
+// so that a game can be played out again from its seed.
+typedef boost::minstd_rand Random;
@@ -1,6 +1,5 @@
 #include "Screen.hpp"
 
-#include "Config.hpp"
 #include "Logger.hpp"
 #include "Point.hpp"
 
@@ -8,23 +7,38 @@
 #pragma warning(push, 0)
 #endif
 
+#include <algorithm>
 #include <SDL_video.h>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
-Screen::Screen(const unsigned long _width, const unsigned long _height)
+Screen::Screen(const unsigned long _width, const unsigned long _height, const Color24 _bgColor)
 {
 	width = _width;
 	height = _height;
 	surface = SDL_SetVideoMode(width, height, 0, SDL_ANYFORMAT | SDL_SWSURFACE);
-	bgColor = Config::Get().screen.bgColor;
+	bgColor = _bgColor;
+	visible = true;
 
 	if(surface == NULL)
 		Logger::Fatal(boost::format("Error creating screen: %1%") % SDL_GetError());
 }
 
+Screen::Screen(SDL_Surface* const _surface, const Color24 _bgColor)
+{
+	surface = _surface;
+	bgColor = _bgColor;
+	visible = false;
+
+	if(surface == NULL)
+		Logger::Fatal(boost::format("Error creating screen: %1%") % SDL_GetError());
+
+	width = surface->w;
+	height = surface->h;
+}
+
 Screen::~Screen()
 {
 	SDL_FreeSurface(surface);
@@ -48,7 +62,7 @@ Point Screen::GetBounds() const
 
 void Screen::Update() const
 {
-	if(SDL_Flip(surface) != 0)
+	if(visible && SDL_Flip(surface) != 0)
 		Logger::Fatal(boost::format("Error updating screen: %1%") % SDL_GetError());
 }
 
@@ -61,3 +75,65 @@ void Screen::Clear() const
 
 	SDL_FillRect(surface, &blank, bgColor.GetRGBMap(surface));
 }
+
+static inline SDL_Rect bounds_to_rect(const Bounds& bounds)
+{
+	SDL_Rect rect;
+	rect.x = bounds.min.x;
+	rect.w = bounds.max.x - bounds.min.x;
+	rect.y = bounds.min.y;
+	rect.h = bounds.max.y - bounds.min.y;
+
+	return rect;
+}
+
+void Screen::Fill(const Bounds& bounds, const Color24 color) const
+{
+	// SDL_Rects only have 16-bit coordinates, so clip first
+	SDL_Rect rect = bounds_to_rect(Clip(bounds));
+
+	if(SDL_FillRect(surface, &rect, color.GetRGBMap(surface)) == -1)
+		Logger::Fatal(boost::format("Error drawing to screen: %1%") % SDL_GetError());
+}
+
+void Screen::Clear(const Bounds& bounds) const
+{
+	Fill(bounds, bgColor);
+}
+
+Bounds Screen::Clip(const Bounds& bounds) const
+{
+	Bounds clipped(Point(std::max<long>(bounds.min.x, 0), std::max<long>(bounds.min.y, 0)),
+		Point(std::min<long>(bounds.max.x, width), std::min<long>(bounds.max.y, height)));
+
+	// nothing at all, if it's entirely off the screen
+	clipped.max.x = std::max(clipped.max.x, clipped.min.x);
+	clipped.max.y = std::max(clipped.max.y, clipped.min.y);
+
+	return clipped;
+}
+
+void Screen::Blit(const Screen& source) const
+{
+	if(SDL_BlitSurface(source.surface, NULL, surface, NULL) != 0)
+		Logger::Fatal(boost::format("Error drawing to screen: %1%") % SDL_GetError());
+}
+
+void Screen::Blit(const Screen& source, const Vector2D offset) const
+{
+	// the part of _source_ which stays on the screen, and where it ends up
+	const Point size(width, height);
+	SDL_Rect sourceRect = bounds_to_rect(Clip(Bounds(-offset, size - offset)));
+	SDL_Rect destinationRect = bounds_to_rect(Clip(Bounds(offset, size + offset)));
+
+	if(SDL_BlitSurface(source.surface, &sourceRect, surface, &destinationRect) != 0)
+		Logger::Fatal(boost::format("Error drawing to screen: %1%") % SDL_GetError());
+}
+
+Screen* Screen::MakeOffscreen() const
+{
+	const SDL_PixelFormat* const format = surface->format;
+
+	return new Screen(SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, format->BitsPerPixel,
+		format->Rmask, format->Gmask, format->Bmask, format->Amask), bgColor);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Bounds.hpp"
 #include "Color24.hpp"
 #include "Point.hpp"
 #include "WorldObject.hpp"
@@ -10,9 +11,13 @@ private:
 	SDL_Surface* surface;
 	unsigned long width, height;
 	Color24 bgColor;
+	// whether or not _surface_ is the display
+	bool visible;
 
 public:
-	Screen(unsigned long width, unsigned long height);
+	Screen(unsigned long width, unsigned long height, Color24 bgColor);
+	// draw to an off-screen _surface_ instead of the display. The Screen takes ownership of it.
+	Screen(SDL_Surface* surface, Color24 bgColor);
 	~Screen();
 
 	Point GetCenter() const;
@@ -23,4 +28,18 @@ public:
 
 	void Update() const;
 	void Clear() const;
+	// fill the part of _bounds_ which is on the screen with the background color
+	void Clear(const Bounds& bounds) const;
+	// fill the part of _bounds_ which is on the screen with _color_
+	void Fill(const Bounds& bounds, Color24 color) const;
+	// the part of _bounds_ which is on the screen (which is empty, if none of it is)
+	Bounds Clip(const Bounds& bounds) const;
+	// copy all of _source_ (which must be the same size) onto this screen
+	void Blit(const Screen& source) const;
+	// copy _source_ (which must be the same size) onto this screen, moved by _offset_. Whatever ends
+	// up off the edge is left out, and whatever _source_ doesn't cover is left as it was.
+	void Blit(const Screen& source, Vector2D offset) const;
+
+	// make a new off-screen Screen with the same size, pixel format and background color as this one
+	Screen* MakeOffscreen() const;
 };
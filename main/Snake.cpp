@@ -2,17 +2,23 @@
 
 #include "Common.hpp"
 #include "Config.hpp"
-#include "Food.hpp"
 #include "Logger.hpp"
 #include "Line.hpp"
+#include "OccupancyGrid.hpp"
+#include "Profiler.hpp"
+#include "Snapshot.hpp"
+#include "StateHash.hpp"
+#include "UniqueObjectCollection.hpp"
 #include "ZippedUniqueObjectCollection.hpp"
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
+#include <algorithm>
 #include <boost/bind.hpp>
-#include <boost/random.hpp>
+#include <climits>
+#include <utility>
 
 #ifdef MSVC
 #pragma warning(pop)
@@ -20,7 +26,10 @@
 
 const static Direction directions[] = {Direction::left, Direction::right, Direction::up, Direction::down};
 
-Snake::Snake(ZippedUniqueObjectCollection& gameObjects)
+Snake::Snake(const Config& _config, const Clock& clock, Random& _random, OccupancyGrid& _occupancy,
+	ZippedUniqueObjectCollection& gameObjects) :
+	config(&_config), random(_random), occupancy(_occupancy), moveTimer(clock), speedupTimer(clock),
+	pointTimer(clock)
 {
 	Init(gameObjects);
 }
@@ -28,10 +37,10 @@ Snake::Snake(ZippedUniqueObjectCollection& gameObjects)
 void Snake::AddSegment(ZippedUniqueObjectCollection& gameObjects)
 {
 	DOLOCKED(pathMutex,
-		const Direction& direction = Head().direction;
+		const Direction direction = Head().GetDirection();
 		// we want to start at the back end of the head
-		const SnakeSegment newSegment(this, Head().GetTailSide().min, direction, 0,
-			Config::Get().snake.width, Config::Get().snake.color);
+		const SnakeSegment newSegment(Head().GetTailSide().min, direction, 0,
+			config->snake.width, config->snake.color);
 	
 		path.insert(++path.begin(), newSegment);
 		DOLOCKEDZ(gameObjects,
@@ -42,14 +51,16 @@ void Snake::AddSegment(ZippedUniqueObjectCollection& gameObjects)
 
 void Snake::AddHead(const Point location, const Direction direction, ZippedUniqueObjectCollection& gameObjects)
 {
-	unsigned short width = Config::Get().snake.width;
-	const SnakeSegment newSegment(this, location, direction, width, width, Config::Get().snake.head.color);
+	unsigned short width = config->snake.width;
+	const SnakeSegment newSegment(location, direction, width, width, config->snake.head.color);
 	
 	DOLOCKED(pathMutex,
 		path.push_front(newSegment);
 		DOLOCKEDZ(gameObjects,
 			gameObjects.Add(Head());
+			gameObjects.focus = Head().GetBounds();
 		)
+		occupancy.Set(Head().GetBounds());
 	)
 }
 
@@ -73,17 +84,16 @@ SnakeSegment& Snake::Shrinkable()
 	return path.back();
 }
 
-static inline Direction get_random_direction()
+static inline Direction get_random_direction(Random& random)
 {
-	const uint32_t randomNumber = boost::minstd_rand(time(NULL))();
-	return directions[randomNumber % countof(directions)];
+	return directions[random() % countof(directions)];
 }
 
-static inline Point get_head_location()
+static inline Point get_head_location(const Config& config)
 {
-	const unsigned long width = Config::Get().snake.width;
-	// middle of the screen
-	Point startingPoint(Config::Get().screen.w / 2, Config::Get().screen.h / 2);
+	const unsigned long width = config.snake.width;
+	// middle of the world
+	Point startingPoint(config.world.w / 2, config.world.h / 2);
 	// account for size
 	startingPoint.x -= width / 2;
 	startingPoint.y -= width / 2;
@@ -96,17 +106,18 @@ void Snake::Init(ZippedUniqueObjectCollection& gameObjects)
 	points = 0;
 
 	moveTimer.Reset();
+	movement = 0;
 	speedupTimer.Reset();
 	pointTimer.Reset();
 
-	speed = Config::Get().snake.startingSpeed;
+	speed = config->snake.startingSpeed;
 
 	length = 0;
-	targetLength = Config::Get().snake.startingLength;
+	targetLength = config->snake.startingLength;
 	
-	const Direction direction = get_random_direction();
+	const Direction direction = get_random_direction(random);
 	DOLOCKED(pathMutex,
-		AddHead(get_head_location(), direction, gameObjects);
+		AddHead(get_head_location(*config), direction, gameObjects);
 		AddSegment(gameObjects);
 	)
 }
@@ -117,12 +128,23 @@ void Snake::Reset(ZippedUniqueObjectCollection& gameObjects)
 		DOLOCKEDZ(gameObjects,
 			gameObjects.RemoveRange(path.begin(), path.end());
 		)
+		for(Path::const_iterator i = path.begin(), end = path.end(); i != end; ++i)
+			occupancy.Unset(i->GetBounds());
 		path.clear();
 
 		Init(gameObjects);
 	)
 }
 
+void Snake::SetConfig(const Config& newConfig)
+{
+	DOLOCKED(pathMutex,
+		DOLOCKED(attribMutex,
+			config = &newConfig;
+		)
+	)
+}
+
 void Snake::RemoveTail(ZippedUniqueObjectCollection& gameObjects)
 {
 	DOLOCKED(pathMutex,
@@ -136,14 +158,17 @@ void Snake::RemoveTail(ZippedUniqueObjectCollection& gameObjects)
 void Snake::ChangeDirection(const Direction newDirection, ZippedUniqueObjectCollection& gameObjects)
 {
 	DOLOCKED(pathMutex,
-		Direction& oldDirection = Head().direction;
+		const Direction oldDirection = Head().GetDirection();
 		// the new direction and old direction can't be both horizontal nor both vertical
 		// the new segment must be long enough to not collide with another segment if it turns
 		if(newDirection.IsHorizontal() ^ oldDirection.IsHorizontal() &&
-			Growable().GetLength() >= Config::Get().snake.width)
+			Growable().GetLength() >= config->snake.width)
 		{
-			oldDirection = newDirection;
-			AddSegment(gameObjects);
+			// the segments are drawn from the graphics thread
+			DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+				Head().SetDirection(newDirection);
+				AddSegment(gameObjects);
+			)
 		}
 	)
 }
@@ -176,54 +201,209 @@ static Direction get_turned_direction(const Direction direction, const Direction
 void Snake::Turn(const Direction turn, ZippedUniqueObjectCollection& gameObjects)
 {
 	DOLOCKED(pathMutex,
-		const Direction direction = Head().direction;
+		const Direction direction = Head().GetDirection();
 	)
 
 	ChangeDirection(get_turned_direction(direction, turn), gameObjects);
 }
 
-void Snake::Update(ZippedUniqueObjectCollection& gameObjects)
+bool Snake::Update(ZippedUniqueObjectCollection& gameObjects)
 {
-	if(pointTimer.ResetIfHasElapsed(Config::Get().pointGainPeriod))
+	PROFILESCOPE(snakeUpdate)
+
+	if(pointTimer.ResetIfHasElapsed(config->pointGainPeriod))
 	{
 		DOLOCKED(attribMutex,
-			points += Config::Get().pointGainAmount;
-			Logger::Debug(boost::format("%1% points gained! (total %2%)")
-				% Config::Get().pointGainAmount % points);
+			points += config->pointGainAmount;
+			LOGDEBUG(boost::format("%1% points gained! (total %2%)")
+				% config->pointGainAmount % points)
 		)
 	}
 
-	if(speedupTimer.ResetIfHasElapsed(Config::Get().snake.speedupPeriod))
+	if(speedupTimer.ResetIfHasElapsed(config->snake.speedupPeriod))
 	{
 		DOLOCKED(attribMutex,
-			speed += Config::Get().snake.speedupAmount;
-			Logger::Debug(boost::format("Speeding up by %1%") % Config::Get().snake.speedupAmount);
+			speed += config->snake.speedupAmount;
+			LOGDEBUG(boost::format("Speeding up by %1%") % config->snake.speedupAmount)
 		)
 	}
 
-	if(moveTimer.ResetIfHasElapsed(1000 / speed))
+	// _speed_ is in steps per second, and a tick can be worth any number of steps
+	DOLOCKED(attribMutex,
+		movement += moveTimer.Lap() * speed;
+	)
+	const unsigned long distance = movement / 1000;
+	movement %= 1000;
+
+	return (distance > 0 && Advance(distance, gameObjects));
+}
+
+// the _depth_ pixels deep strip just in front of _bounds_, in _direction_
+static inline Bounds get_leading_strip(const Bounds& bounds, const Vector2D direction, const long depth)
+{
+	Bounds strip = bounds;
+	if(direction.x > 0)
 	{
-		DOLOCKED(pathMutex,
-			Head().Move();
-			Growable().Grow();
+		strip.min.x = bounds.max.x;
+		strip.max.x = bounds.max.x + depth;
+	}
+	else if(direction.x < 0)
+	{
+		strip.max.x = bounds.min.x;
+		strip.min.x = bounds.min.x - depth;
+	}
+	else if(direction.y > 0)
+	{
+		strip.min.y = bounds.max.y;
+		strip.max.y = bounds.max.y + depth;
+	}
+	else
+	{
+		strip.max.y = bounds.min.y;
+		strip.min.y = bounds.min.y - depth;
+	}
 
-			DOLOCKED(attribMutex,
-				if(length > targetLength)
-				{
-					if(Shrinkable().Shrink())
-						RemoveTail(gameObjects);
-					--length;
-				}
-
-				// if we need more length, just don't shrink the tail
-				if(length < targetLength)
-					++length;
-				else
-					if(Shrinkable().Shrink())
-						RemoveTail(gameObjects);
-			)
+	return strip;
+}
+
+// the extent of _bounds_ along the axis of _direction_, measured in _direction_
+static inline std::pair<long, long> get_extent_along(const Bounds& bounds, const Vector2D direction)
+{
+	if(direction.x > 0)
+		return std::make_pair(bounds.min.x, bounds.max.x);
+	if(direction.x < 0)
+		return std::make_pair(-bounds.max.x, -bounds.min.x);
+	if(direction.y > 0)
+		return std::make_pair(bounds.min.y, bounds.max.y);
+
+	return std::make_pair(-bounds.max.y, -bounds.min.y);
+}
+
+// how many steps _head_ can take in _direction_ before it overlaps _obstacle_:
+// -1 if it already does, and LONG_MAX if it never will
+static long get_clearance(const Bounds& head, const Direction direction, const Bounds& obstacle)
+{
+	// if they don't overlap across the direction of travel, they never will
+	if(direction.IsHorizontal() ?
+		!(head.min.y < obstacle.max.y && obstacle.min.y < head.max.y) :
+		!(head.min.x < obstacle.max.x && obstacle.min.x < head.max.x))
+		return LONG_MAX;
+
+	const std::pair<long, long> headExtent = get_extent_along(head, direction);
+	const std::pair<long, long> obstacleExtent = get_extent_along(obstacle, direction);
+
+	// behind the head
+	if(obstacleExtent.second <= headExtent.first)
+		return LONG_MAX;
+
+	if(obstacleExtent.first < headExtent.second)
+		return -1;
+
+	return obstacleExtent.first - headExtent.second;
+}
+
+long Snake::GetClearance(const unsigned long limit, const EntityStore& entities)
+{
+	const Bounds headBounds = Head().GetBounds();
+	const Direction direction = Head().GetDirection();
+	const Vector2D step = direction;
+
+	// walls and the snake are in _occupancy_, so test the pixels in front of the head one line at a time
+	long clearance = 0;
+	for(Bounds edge = get_leading_strip(headBounds, step, 1);
+		clearance < static_cast<long>(limit) && !occupancy.Any(edge); edge += step)
+		++clearance;
+
+	// food is eaten by whichever segment ends up over it, so only mines are in the way
+	const EntityStore::TypeArray& types = entities.GetTypes();
+	const EntityStore::BoundsArray& bounds = entities.GetBounds();
+	for(EntityStore::Index i = 0, count = entities.GetCount(); i < count && clearance >= 0; ++i)
+		if(types[i] == WorldObject::mine)
+			clearance = std::min(clearance, get_clearance(headBounds, direction, bounds[i]));
+
+	return clearance;
+}
+
+bool Snake::Advance(const unsigned long distance, ZippedUniqueObjectCollection& gameObjects)
+{
+	bool crashed = false;
+
+	// everything but the head only follows where the head has been, so only the head can run into
+	// anything. Go as far as possible in one move, or one step into whatever's in the way, so it's
+	// found where moving a step at a time would have found it. The tail may have moved out of the way
+	// by then, in which case carry on.
+	DOLOCKED(pathMutex,
+		// the segments are drawn from the graphics thread
+		DOLOCKEDP(graphicsLockWait, gameObjects.graphics.mutex,
+			for(unsigned long remaining = distance; remaining > 0 && !crashed;)
+			{
+				const long clearance = GetClearance(remaining, gameObjects.entities);
+				if(clearance < 0)
+					break;
+
+				const unsigned long steps = std::min(remaining, static_cast<unsigned long>(clearance) + 1);
+				crashed = Move(steps, gameObjects);
+				remaining -= steps;
+			}
+
+			gameObjects.focus = Head().GetBounds();
 		)
-	}
+	)
+
+	return crashed;
+}
+
+void Snake::ShrinkTail(unsigned long amount, ZippedUniqueObjectCollection& gameObjects)
+{
+	DOLOCKED(pathMutex,
+		while(amount > 0)
+		{
+			SnakeSegment& tail = Shrinkable();
+			const unsigned long shrinkage = std::min(amount, tail.GetLength());
+			amount -= shrinkage;
+
+			const bool empty = tail.Shrink(shrinkage);
+			occupancy.Unset(get_leading_strip(tail.GetBounds(), -tail.GetDirection(), shrinkage));
+			if(empty)
+				RemoveTail(gameObjects);
+		}
+	)
+}
+
+bool Snake::Move(const unsigned long distance, ZippedUniqueObjectCollection& gameObjects)
+{
+	DOLOCKED(pathMutex,
+		const Bounds sweep = get_leading_strip(Head().GetBounds(), Head().GetDirection(), distance);
+		Head().Move(distance);
+		Growable().Grow(distance);
+
+		// each step lengthens the snake by one while it's shorter than _targetLength_ (by not moving
+		// the tail), shortens it by one while it's longer (by moving the tail twice), and otherwise
+		// just moves the tail along
+		DOLOCKED(attribMutex,
+			unsigned long shrinkage;
+			if(length < targetLength)
+			{
+				const unsigned long growth = std::min(distance, targetLength - length);
+				length += growth;
+				shrinkage = distance - growth;
+			}
+			else
+			{
+				const unsigned long loss = std::min(distance, length - targetLength);
+				length -= loss;
+				shrinkage = distance + loss;
+			}
+		)
+
+		ShrinkTail(shrinkage, gameObjects);
+
+		// only now that the tail's out of the way
+		const bool crashed = occupancy.Any(sweep);
+		occupancy.Set(sweep);
+	)
+
+	return crashed;
 }
 
 // add _change_ to _original_. If doing so goes below _min_, set it to _min_ instead
@@ -237,24 +417,134 @@ void SumUp(const _T change, _X& original, const _X min)
 		original += change;
 }
 
-void Snake::EatFood(const Food& foodObj)
+void Snake::EatFood(const EntityStore::FoodEffects& effects)
 {
-	const Config::SnakeConfig& snakeConfig = Config::Get().snake;
-
-	const double baseUncappedGrowth = targetLength * snakeConfig.growthRate;
-	const double baseRealGrowth = std::min((double)snakeConfig.growthCap, baseUncappedGrowth);
-	const long growthAmount = intRound(baseRealGrowth * foodObj.GetLengthFactor());
-	const long long pointChange = foodObj.GetPointChange();
-	const short speedChange = foodObj.GetSpeedChange();
+	const long long pointChange = effects.pointChange;
+	const short speedChange = effects.speedChange;
 	const unsigned long long defaultPoints = 0;
 
 	DOLOCKED(attribMutex,
+		const Config::SnakeConfig& snakeConfig = config->snake;
+
+		const double baseUncappedGrowth = targetLength * snakeConfig.growthRate;
+		const double baseRealGrowth = std::min((double)snakeConfig.growthCap, baseUncappedGrowth);
+		const long growthAmount = intRound(baseRealGrowth * effects.lengthFactor);
+
 		SumUp(pointChange, points, defaultPoints);
 		SumUp(growthAmount, targetLength, snakeConfig.startingLength);
 		SumUp(speedChange, speed, snakeConfig.startingSpeed);
 	)
 
-	Logger::Debug(boost::format("Growing by %1%") % growthAmount);
-	Logger::Debug(boost::format("Got %1% points! (total %2%)") % pointChange % points);
-	Logger::Debug(boost::format("Speeding up by %1%") % speedChange);
+	LOGDEBUG(boost::format("Growing by %1%") % growthAmount)
+	LOGDEBUG(boost::format("Got %1% points! (total %2%)") % pointChange % points)
+	LOGDEBUG(boost::format("Speeding up by %1%") % speedChange)
+}
+
+void Snake::AddToHash(StateHash& hash) const
+{
+	DOLOCKED(pathMutex,
+		DOLOCKED(attribMutex,
+			hash.Add(length);
+			hash.Add(targetLength);
+			hash.Add(speed);
+			hash.Add(movement);
+			hash.Add(points);
+		)
+
+		for(Path::const_iterator i = path.begin(), end = path.end(); i != end; ++i)
+		{
+			const Bounds bounds = i->GetBounds();
+			const Vector2D direction = i->GetDirection();
+
+			hash.Add(bounds.min.x);
+			hash.Add(bounds.min.y);
+			hash.Add(bounds.max.x);
+			hash.Add(bounds.max.y);
+			hash.Add(direction.x);
+			hash.Add(direction.y);
+		}
+	)
+}
+
+template <typename Archive>
+void Snake::Serialize(Archive& archive)
+{
+	// everything goes through fixed-size copies, so snapshots are the same on every platform, and a
+	// snapshot that's cut short throws before any of this snake has been replaced
+	boost::uint64_t archivedLength = 0, archivedTargetLength = 0, archivedPoints = 0, archivedMovement = 0;
+	boost::uint16_t archivedSpeed = 0;
+	Timer archivedMoveTimer(moveTimer), archivedSpeedupTimer(speedupTimer), archivedPointTimer(pointTimer);
+	boost::uint32_t segmentCount = 0;
+
+	if(!Archive::is_loading::value)
+	{
+		DOLOCKED(pathMutex,
+			DOLOCKED(attribMutex,
+				archivedLength = length;
+				archivedTargetLength = targetLength;
+				archivedSpeed = speed;
+				archivedPoints = points;
+			)
+
+			archivedMovement = movement;
+			segmentCount = path.size();
+		)
+	}
+
+	archive & archivedLength & archivedTargetLength & archivedSpeed & archivedPoints;
+	archivedMoveTimer.Serialize(archive);
+	archive & archivedMovement;
+	archivedSpeedupTimer.Serialize(archive);
+	archivedPointTimer.Serialize(archive);
+	archive & segmentCount;
+
+	if(Archive::is_loading::value)
+	{
+		Path archivedPath(segmentCount, SnakeSegment(Point(), Direction::empty, 0, 0, Color24()));
+		for(Path::iterator i = archivedPath.begin(), end = archivedPath.end(); i != end; ++i)
+			i->Serialize(archive);
+
+		DOLOCKED(pathMutex,
+			DOLOCKED(attribMutex,
+				length = archivedLength;
+				targetLength = archivedTargetLength;
+				speed = archivedSpeed;
+				points = archivedPoints;
+			)
+
+			moveTimer = archivedMoveTimer;
+			movement = archivedMovement;
+			speedupTimer = archivedSpeedupTimer;
+			pointTimer = archivedPointTimer;
+			path.swap(archivedPath);
+		)
+	}
+	else
+	{
+		DOLOCKED(pathMutex,
+			for(Path::iterator i = path.begin(), end = path.end(); i != end; ++i)
+				i->Serialize(archive);
+		)
+	}
+}
+
+template void Snake::Serialize(SnapshotWriter& archive);
+template void Snake::Serialize(SnapshotReader& archive);
+
+Bounds Snake::GetHeadBounds()
+{
+	Bounds bounds;
+	DOLOCKED(pathMutex,
+		bounds = Head().GetBounds();
+	)
+
+	return bounds;
+}
+
+void Snake::GetSegments(std::vector<WorldObject*>& segments)
+{
+	DOLOCKED(pathMutex,
+		for(Path::iterator i = path.begin(), end = path.end(); i != end; ++i)
+			segments.push_back(&*i);
+	)
 }
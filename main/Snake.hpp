@@ -1,6 +1,8 @@
 #pragma once
 
+#include "EntityStore.hpp"
 #include "Mutex.hpp"
+#include "Random.hpp"
 #include "SnakeSegment.hpp"
 #include "Timer.hpp"
 
@@ -9,14 +11,17 @@
 #endif
 
 #include <list>
+#include <vector>
 
 #ifdef MSVC
 #pragma warning(pop)
 #endif
 
+struct Config;
 class Direction;
 class GameWorld;
-class Food;
+class OccupancyGrid;
+class StateHash;
 struct ZippedUniqueObjectCollection;
 
 class Snake
@@ -25,6 +30,13 @@ public:
 	typedef std::list<SnakeSegment> Path;
 
 private:
+	// only changed (by SetConfig) with both _pathMutex_ and _attribMutex_ held
+	const Config* config;
+	// the game world's random number generator
+	Random& random;
+	// the game world's occupancy grid, which this keeps up to date with the snake's segments
+	OccupancyGrid& occupancy;
+
 	RecursiveMutex pathMutex;
 	Mutex attribMutex;
 
@@ -36,6 +48,8 @@ private:
 	unsigned short speed;
 
 	Timer moveTimer;
+	// progress towards the next step, in thousandths of a step
+	unsigned long movement;
 	Timer speedupTimer;
 	Timer pointTimer;
 
@@ -54,12 +68,25 @@ private:
 	// return the last segment
 	SnakeSegment& Tail();
 
+	// shrink the tail end of the snake by _amount_, removing segments as they empty
+	void ShrinkTail(unsigned long amount, ZippedUniqueObjectCollection& gameObjects);
+	// how many steps (up to _limit_) the head can take before it runs into a wall, the snake, or
+	// a mine in _entities_, or -1 if it's already in a mine
+	long GetClearance(unsigned long limit, const EntityStore& entities);
+	// move _distance_ steps, stopping one step into the first thing in the way.
+	// Returns true iff the head ran into a wall or the snake.
+	bool Advance(unsigned long distance, ZippedUniqueObjectCollection& gameObjects);
+
 	void Init(ZippedUniqueObjectCollection& gameObjects);
 
 public:
-	Snake(ZippedUniqueObjectCollection& gameObjects);
+	// _clock_, _random_ and _occupancy_ are the game world's
+	Snake(const Config& config, const Clock& clock, Random& random, OccupancyGrid& occupancy,
+		ZippedUniqueObjectCollection& gameObjects);
 
 	void Reset(ZippedUniqueObjectCollection& gameObjects);
+	// start using _config_ (e.g. after it's been reloaded), without resetting
+	void SetConfig(const Config& config);
 
 	void RemoveTail(ZippedUniqueObjectCollection& gameObjects);
 
@@ -68,7 +95,22 @@ public:
 	// turn the snake relative to the direction provided
 	void Turn(Direction turnDirection, ZippedUniqueObjectCollection& gameObjects);
 
-	void Update(ZippedUniqueObjectCollection& gameObjects);
+	// returns true iff the snake ran into a wall or itself (other collisions are left to the physics pass)
+	bool Update(ZippedUniqueObjectCollection& gameObjects);
+	// move _distance_ steps in the current direction, growing or shrinking towards the target length.
+	// Returns true iff the head's new pixels were already occupied (see OccupancyGrid).
+	bool Move(unsigned long distance, ZippedUniqueObjectCollection& gameObjects);
+
+	void EatFood(const EntityStore::FoodEffects& effects);
+
+	// mix this snake's state into _hash_
+	void AddToHash(StateHash& hash) const;
 
-	void EatFood(const Food&);
+	// read or write this snake's state (including its segments, but not their membership
+	// of the game objects) through _archive_ (see GameWorld::SaveSnapshot)
+	template <typename Archive>
+	void Serialize(Archive& archive);
+	Bounds GetHeadBounds();
+	// append all of this snake's segments to _segments_, head first
+	void GetSegments(std::vector<WorldObject*>& segments);
 };
@@ -3,102 +3,108 @@
 #include "Common.hpp"
 #include "Config.hpp"
 #include "Line.hpp"
-#include "Snake.hpp"
 
-SnakeSegment::SnakeSegment(Snake* const _parent, const Point location, const Direction _direction,
-	const unsigned long length, const unsigned short _width, const Color24 color) :
-	WorldObject(snake, color)
-{
-	direction = _direction;
-	parent = _parent;
-	width = _width;
-	bounds.min = location;
-	bounds.max = location;
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
 
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+SnakeSegment::SnakeSegment(const Point location, const Direction _direction, const unsigned long _length,
+	const unsigned short _width, const Color24 color) :
+	WorldObject(snake, color), width(_width), direction(_direction)
+{
 	Vector2D size;
 	// if it's moving horizontally, its width is vertical
 	if(direction.IsHorizontal())
-		size = Vector2D(length, width);
+		size = Vector2D(_length, width);
 	else
-		size = Vector2D(width, length);
+		size = Vector2D(width, _length);
 
+	Bounds bounds(location, location);
 	bounds.max += size;
+	SetBounds(bounds);
 }
 
-void SnakeSegment::CollisionHandler(WorldObject& obj) const
+Bounds SnakeSegment::GetBounds() const
 {
-	obj.CollisionHandler(*this);
+	const Vector2D v = direction;
+	// the far corner of the front side
+	Point corner = origin;
+	corner += v * length;
+	corner += Vector2D(v.y != 0, v.x != 0) * width;
+
+	return Bounds(Point(std::min(origin.x, corner.x), std::min(origin.y, corner.y)),
+		Point(std::max(origin.x, corner.x), std::max(origin.y, corner.y)));
 }
 
-void SnakeSegment::CollisionHandler(const Food& food)
+void SnakeSegment::SetBounds(const Bounds& bounds)
 {
-	parent->EatFood(food);
+	const Vector2D v = direction;
+	origin = bounds.min;
+	// going left or up, the back side is the maximum one
+	if(v.x < 0)
+		origin.x = bounds.max.x;
+	if(v.y < 0)
+		origin.y = bounds.max.y;
+
+	length = direction.IsHorizontal() ? bounds.max.x - bounds.min.x : bounds.max.y - bounds.min.y;
 }
 
-void SnakeSegment::ModifyLength(const long amount)
+Direction SnakeSegment::GetDirection() const
 {
-	DOLOCKED(mutex,
-		const Vector2D v = direction;
-		if(amount > 0)
-		{
-			// move the front side forward by _amount_ (i.e. grow)
-			SetHeadSide(GetHeadSide() + (v * amount));
-		}
-		else
-		{
-			// move the back side forward by _amount_ (i.e. shrink)
-			SetTailSide(GetTailSide() + (v * -amount));
-		}
-	)
+	return direction;
 }
 
-void SnakeSegment::Move()
+void SnakeSegment::SetDirection(const Direction newDirection)
 {
-	bounds += direction;
+	const Bounds bounds = GetBounds();
+	direction = newDirection;
+	SetBounds(bounds);
 }
 
-void SnakeSegment::Grow()
+void SnakeSegment::Move(const unsigned long distance)
 {
-	ModifyLength(1);
+	origin += static_cast<Vector2D>(direction) * distance;
 }
 
-bool SnakeSegment::Shrink()
+void SnakeSegment::Grow(const unsigned long amount)
 {
-	ModifyLength(-1);
-
-	// if bounds are exceeded, this segment is empty
-	return (bounds.min.x >= bounds.max.x || bounds.min.y >= bounds.max.y);
+	length += amount;
 }
 
-unsigned long SnakeSegment::GetLength() const
+bool SnakeSegment::Shrink(const unsigned long amount)
 {
-#define DELTA(m) (bounds.max.m - bounds.min.m)
-	// if moving horizontally, the length is delta X, otherwise delta y
-	if(direction.IsHorizontal())
-		return DELTA(x);
+	origin += static_cast<Vector2D>(direction) * amount;
+	length -= amount;
 
-	return DELTA(y);
-#undef DELTA
+	return (length == 0);
 }
 
-Line SnakeSegment::GetHeadSide() const
+unsigned long SnakeSegment::GetLength() const
 {
-	// the _direction_ side is the front
-	return bounds.GetSide(direction);
+	return length;
 }
 
-void SnakeSegment::SetHeadSide(Line side)
+Line SnakeSegment::GetHeadSide() const
 {
-	bounds.SetSide(side, direction);
+	Line side = GetTailSide();
+	side.min += static_cast<Vector2D>(direction) * length;
+
+	return side;
 }
 
 Line SnakeSegment::GetTailSide() const
 {
-	// the -_direction_ side is the back
-	return bounds.GetSide(-direction);
-}
+	Line side;
+	side.min = origin;
+	side.length = width;
+	// the sides run across the direction of travel
+	side.horizontal = !direction.IsHorizontal();
 
-void SnakeSegment::SetTailSide(Line side)
-{
-	bounds.SetSide(side, -direction);
+	return side;
 }
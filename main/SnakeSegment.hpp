@@ -3,47 +3,70 @@
 #include "Direction.hpp"
 #include "WorldObject.hpp"
 
-class Food;
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <SDL_types.h>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
 struct Line;
-class Snake;
-struct ZippedUniqueObjectCollection;
 
-// rectangular segment of snake
+// rectangular segment of snake. Rather than its bounds, it stores where its back side starts,
+// how long it is, and which way it's going, so moving, growing and shrinking are each one add
 class SnakeSegment : public WorldObject
 {
 private:
-	unsigned short width;
+	// these two pack in after WorldObject's members
+	Uint16 width;
+	// direction of movement
+	Direction direction;
 
-	Snake* parent;
+	// the end of the back side with the lowest coordinates
+	Point origin;
+	boost::uint32_t length;
 
-	// change length by _amount_
-	void ModifyLength(long amount);
+	// take on _bounds_, keeping the current direction
+	void SetBounds(const Bounds& bounds);
 
 public:
-	// direction of movement
-	Direction direction;
+	// _location_ is the corner with the lowest coordinates
+	SnakeSegment(Point location, Direction direction, unsigned long length, unsigned short width, Color24);
+
+	Bounds GetBounds() const;
 
-	SnakeSegment(Snake* parent, Point location, Direction direction, unsigned long length,
-		unsigned short width, Color24);
-	
-	void CollisionHandler(WorldObject&) const;
-	void CollisionHandler(const Food&);
+	Direction GetDirection() const;
+	// change direction without moving (the segment must be square)
+	void SetDirection(Direction direction);
 
-	// move one step in the current direction
-	void Move();
+	// move _distance_ steps in the current direction
+	void Move(unsigned long distance);
 
-	void Grow();
-	// return true if the segment became empty
-	bool Shrink();
+	void Grow(unsigned long amount);
+	// shrink by _amount_ (at most the segment's length) from the back.
+	// Returns true if the segment became empty.
+	bool Shrink(unsigned long amount);
 
 	unsigned long GetLength() const;
 
 	// get the frontmost side of this segment
 	Line GetHeadSide() const;
-	// set the frontmost side of this segment
-	void SetHeadSide(Line side);
 	// get the backmost side of this segment
 	Line GetTailSide() const;
-	// set the backmost side of this segment
-	void SetTailSide(Line side);
+
+	template <typename Archive>
+	void Serialize(Archive& archive)
+	{
+		SerializeColor(archive);
+		archive & origin.x & origin.y & length & width;
+		direction.Serialize(archive);
+	}
 };
+
+// the vtable pointer, and everything else in 24 bytes
+BOOST_STATIC_ASSERT(sizeof(SnakeSegment) <= sizeof(void*) + 24);
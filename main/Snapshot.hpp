@@ -0,0 +1,21 @@
+#pragma once
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// The archives game world snapshots are written and read with (see GameWorld::SaveSnapshot).
+// Only primitives are ever put through them, so they're just the raw values back to back,
+// in the native byte order.
+typedef boost::archive::binary_oarchive SnapshotWriter;
+typedef boost::archive::binary_iarchive SnapshotReader;
+
+// skip the archive header and locale handling, which would cost more than the snapshot itself
+static const unsigned int snapshotArchiveFlags = boost::archive::no_header | boost::archive::no_codecvt;
@@ -1,6 +1,5 @@
 #include "Sound.hpp"
 
-#include "Config.hpp"
 #include "Logger.hpp"
 
 #ifdef MSVC
@@ -16,21 +15,13 @@
 
 Sound::Sound(const std::string& filename)
 {
-	if(Config::Get().sound)
-	{
-		sound = Mix_LoadWAV(filename.c_str());
-
-		// SDL error conditions
-		if(sound == NULL || (channel = Mix_PlayChannel(-1, sound, 0)) == -1)
-		{
-			Logger::Debug(boost::format("Error playing sound \"%1%\": %2%")
-				% filename.c_str() % Mix_GetError());
-			return;
-		}
-	}
-	else
+	sound = Mix_LoadWAV(filename.c_str());
+
+	// SDL error conditions
+	if(sound == NULL || (channel = Mix_PlayChannel(-1, sound, 0)) == -1)
 	{
-		sound = NULL;
+		LOGDEBUG(boost::format("Error playing sound \"%1%\": %2%")
+			% filename.c_str() % Mix_GetError())
 		channel = -1;
 	}
 }
@@ -0,0 +1,84 @@
+#include "SpatialIndex.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+SpatialIndex::SpatialIndex(const unsigned long _cellSize) :
+	cellSize(std::max<unsigned long>(_cellSize, 1)), origin(0, 0), columns(0), rows(0)
+{
+}
+
+void SpatialIndex::Reset(const Bounds& area)
+{
+	origin = area.min;
+	columns = (std::max<long>(area.max.x - area.min.x, 0) + cellSize - 1) / cellSize;
+	rows = (std::max<long>(area.max.y - area.min.y, 0) + cellSize - 1) / cellSize;
+
+	cells.assign(columns * rows, std::vector<Item>());
+	items.clear();
+}
+
+bool SpatialIndex::GetCellRange(const Point::Coordinate min, const Point::Coordinate max,
+	const unsigned long cellCount, unsigned long& first, unsigned long& last) const
+{
+	if(min >= max || max <= 0 || cellCount == 0)
+		return false;
+
+	first = std::max<Point::Coordinate>(min, 0) / cellSize;
+	if(first >= cellCount)
+		return false;
+
+	last = std::min<unsigned long>((max - 1) / cellSize, cellCount - 1);
+	return true;
+}
+
+SpatialIndex::Item SpatialIndex::Insert(const Bounds& bounds)
+{
+	const Item item = items.size();
+	items.push_back(bounds);
+
+	unsigned long x0, x1, y0, y1;
+	if(GetCellRange(bounds.min.x - origin.x, bounds.max.x - origin.x, columns, x0, x1) &&
+		GetCellRange(bounds.min.y - origin.y, bounds.max.y - origin.y, rows, y0, y1))
+	{
+		for(unsigned long y = y0; y <= y1; ++y)
+			for(unsigned long x = x0; x <= x1; ++x)
+				cells[y * columns + x].push_back(item);
+	}
+
+	return item;
+}
+
+unsigned long SpatialIndex::GetCount() const
+{
+	return items.size();
+}
+
+void SpatialIndex::Query(const Bounds& region, std::vector<Item>& result) const
+{
+	unsigned long x0, x1, y0, y1;
+	if(!GetCellRange(region.min.x - origin.x, region.max.x - origin.x, columns, x0, x1) ||
+		!GetCellRange(region.min.y - origin.y, region.max.y - origin.y, rows, y0, y1))
+		return;
+
+	const std::vector<Item>::size_type begin = result.size();
+	for(unsigned long y = y0; y <= y1; ++y)
+		for(unsigned long x = x0; x <= x1; ++x)
+		{
+			const std::vector<Item>& cell = cells[y * columns + x];
+			for(std::vector<Item>::const_iterator i = cell.begin(), end = cell.end(); i != end; ++i)
+				if(items[*i].Overlaps(region))
+					result.push_back(*i);
+		}
+
+	// items in more than one of the cells were found more than once
+	std::sort(result.begin() + begin, result.end());
+	result.erase(std::unique(result.begin() + begin, result.end()), result.end());
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Bounds.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// Finds which of a set of rectangles overlap a region, without looking at the rest. Each rectangle
+// is listed in every cell it touches of a uniform grid, so a query only looks at the cells the
+// region touches. Rectangles are referred to by their index in the order they were inserted.
+class SpatialIndex
+{
+public:
+	typedef boost::uint32_t Item;
+
+	static const unsigned long defaultCellSize = 256;
+
+private:
+	const unsigned long cellSize;
+	// the grid's top-left corner, and its size in cells
+	Point origin;
+	unsigned long columns, rows;
+	// the items touching each cell, row by row
+	std::vector<std::vector<Item> > cells;
+	// the bounds of each item
+	std::vector<Bounds> items;
+
+	// the range of cells [_first_, _last_] along an axis which [_min_, _max_) (relative to the grid's
+	// origin) touches, or false if none
+	bool GetCellRange(Point::Coordinate min, Point::Coordinate max, unsigned long cellCount,
+		unsigned long& first, unsigned long& last) const;
+
+public:
+	explicit SpatialIndex(unsigned long cellSize = defaultCellSize);
+
+	// remove everything, and cover _area_. Anything outside it is never found.
+	void Reset(const Bounds& area);
+	// add _bounds_ as the next item
+	Item Insert(const Bounds& bounds);
+	unsigned long GetCount() const;
+
+	// append every item overlapping _region_ to _result_, in insertion order
+	void Query(const Bounds& region, std::vector<Item>& result) const;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// 64-bit FNV-1a, for checking whether two simulations are in the same state
+class StateHash
+{
+public:
+	typedef boost::uint64_t ValueType;
+
+private:
+	ValueType value;
+
+public:
+	StateHash() :
+		value(14695981039346656037ULL)
+	{
+	}
+
+	// mix _x_ (all 8 bytes of it, low byte first) into the hash
+	void Add(const ValueType x)
+	{
+		for(unsigned int i = 0; i < 8; ++i)
+		{
+			value ^= (x >> (i * 8)) & 0xff;
+			value *= 1099511628211ULL;
+		}
+	}
+
+	ValueType GetValue() const
+	{
+		return value;
+	}
+};
@@ -0,0 +1,120 @@
+#include "ThreadPool.hpp"
+
+#include "Common.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+ThreadPool::ThreadPool(const unsigned long threadCount) :
+	workers(std::max<unsigned long>(threadCount, 1)), queued(0), pending(0), nextWorker(0), stopping(false)
+{
+	for(unsigned long i = 0; i < workers.size(); ++i)
+		threads.create_thread(boost::bind(&ThreadPool::WorkLoop, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+	Wait();
+
+	{
+		const boost::mutex::scoped_lock lock(idleMutex);
+		stopping = true;
+		workAvailable.notify_all();
+	}
+
+	threads.join_all();
+}
+
+void ThreadPool::Submit(const Task& task)
+{
+	const unsigned long* const self = currentWorker.get();
+	Worker* const worker = &workers[(self != NULL) ? *self : nextWorker++ % workers.size()];
+
+	++pending;
+	DOLOCKED(worker->mutex,
+		worker->tasks.push_back(task);
+	)
+	++queued;
+
+	const boost::mutex::scoped_lock lock(idleMutex);
+	workAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	boost::mutex::scoped_lock lock(idleMutex);
+	while(pending > 0)
+		allDone.wait(lock);
+}
+
+unsigned long ThreadPool::GetThreadCount() const
+{
+	return workers.size();
+}
+
+bool ThreadPool::TryTake(const unsigned long self, Task& task)
+{
+	for(unsigned long i = 0; i < workers.size(); ++i)
+	{
+		Worker& worker = workers[(self + i) % workers.size()];
+		const bool own = (i == 0);
+
+		DOLOCKED(worker.mutex,
+			const bool found = !worker.tasks.empty();
+			if(found)
+			{
+				task.swap(own ? worker.tasks.back() : worker.tasks.front());
+				if(own)
+					worker.tasks.pop_back();
+				else
+					worker.tasks.pop_front();
+			}
+		)
+
+		if(found)
+		{
+			--queued;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::WorkLoop(const unsigned long self)
+{
+	currentWorker.reset(new unsigned long(self));
+
+	Task task;
+	while(true)
+	{
+		if(TryTake(self, task))
+		{
+			task();
+			task.clear();
+
+			if(--pending == 0)
+			{
+				const boost::mutex::scoped_lock lock(idleMutex);
+				allDone.notify_all();
+			}
+
+			continue;
+		}
+
+		boost::mutex::scoped_lock lock(idleMutex);
+		while(queued == 0 && !stopping)
+			workAvailable.wait(lock);
+
+		if(queued == 0 && stopping)
+			return;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Mutex.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <deque>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// A fixed set of worker threads running tasks. Each worker has a queue of its own, which it runs
+// the newest tasks from first; a worker with an empty queue steals the oldest task from another's.
+// Tasks submitted from inside a task go to the submitting worker's own queue, so a task which keeps
+// resubmitting itself mostly stays on one thread, and workers only contend when one runs dry.
+class ThreadPool : private boost::noncopyable
+{
+public:
+	typedef boost::function<void ()> Task;
+
+private:
+	struct Worker
+	{
+		std::deque<Task> tasks;
+		Mutex mutex;
+	};
+
+	std::vector<Worker> workers;
+	boost::thread_group threads;
+	// the index of the worker the current thread is, if it's one of ours
+	boost::thread_specific_ptr<unsigned long> currentWorker;
+
+	// tasks waiting in the queues, and tasks submitted but not finished yet
+	boost::atomic<unsigned long> queued;
+	boost::atomic<unsigned long> pending;
+	// where tasks from outside the pool go next
+	boost::atomic<unsigned long> nextWorker;
+	boost::atomic<bool> stopping;
+
+	// idle workers wait on _workAvailable_, and Wait() waits on _allDone_
+	boost::mutex idleMutex;
+	boost::condition_variable workAvailable;
+	boost::condition_variable allDone;
+
+	// take a task from the back of _self_'s queue, or else from the front of someone else's
+	bool TryTake(unsigned long self, Task& task);
+	void WorkLoop(unsigned long self);
+
+public:
+	explicit ThreadPool(unsigned long threadCount);
+	// runs everything that was submitted, then stops the workers
+	~ThreadPool();
+
+	// queue _task_ to run on one of the workers. This can be called from any thread, including the workers.
+	void Submit(const Task& task);
+	// wait until every task submitted so far (and every task they submit) has finished
+	void Wait();
+
+	unsigned long GetThreadCount() const;
+};
@@ -0,0 +1,182 @@
+#include "TiledRenderer.hpp"
+
+#include "Camera.hpp"
+#include "Color24.hpp"
+#include "EntityStore.hpp"
+#include "Graphics.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include "Screen.hpp"
+#include "UniqueObjectCollection.hpp"
+#include "WorldObject.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <cstring>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Graphics
+{
+	TiledRenderer::TiledRenderer(const unsigned long threadCount, const unsigned long _tileSize) :
+		pool(threadCount), tileSize(std::max<unsigned long>(_tileSize, 1)), tileColumns(0), tileRows(0),
+		palettePixels(Palette::maxColors), paletteMapped(Palette::maxColors)
+	{
+	}
+
+	Uint32 TiledRenderer::GetPixel(const Palette::Index color, const SDL_Surface* const surface)
+	{
+		if(!paletteMapped[color])
+		{
+			palettePixels[color] = Palette::GetColor(color).GetRGBMap(surface);
+			paletteMapped[color] = true;
+			mappedColors.push_back(color);
+		}
+
+		return palettePixels[color];
+	}
+
+	void TiledRenderer::AddFill(const Bounds& bounds, const Uint32 pixel)
+	{
+		if(bounds.min.x >= bounds.max.x || bounds.min.y >= bounds.max.y)
+			return;
+
+		const boost::uint32_t index = fills.size();
+		Fill fill;
+		fill.bounds = bounds;
+		fill.pixel = pixel;
+		fills.push_back(fill);
+
+		for(unsigned long y = bounds.min.y / tileSize, yEnd = (bounds.max.y - 1) / tileSize; y <= yEnd; ++y)
+			for(unsigned long x = bounds.min.x / tileSize, xEnd = (bounds.max.x - 1) / tileSize; x <= xEnd; ++x)
+				bins[y * tileColumns + x].push_back(index);
+	}
+
+	// fill pixels [_begin_, _end_) of _row_ with _pixel_, the way SDL_FillRect does
+	static inline void fill_span(Uint8* const row, const long begin, const long end, const Uint32 pixel,
+		const unsigned int bytesPerPixel)
+	{
+		switch(bytesPerPixel)
+		{
+			case 1:
+				memset(row + begin, static_cast<Uint8>(pixel), end - begin);
+				break;
+
+			case 2:
+				std::fill(reinterpret_cast<Uint16*>(row) + begin, reinterpret_cast<Uint16*>(row) + end,
+					static_cast<Uint16>(pixel));
+				break;
+
+			case 3:
+				for(Uint8* p = row + begin * 3, * const pEnd = row + end * 3; p != pEnd; p += 3)
+				{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+					p[0] = static_cast<Uint8>(pixel >> 16);
+					p[1] = static_cast<Uint8>(pixel >> 8);
+					p[2] = static_cast<Uint8>(pixel);
+#else
+					p[0] = static_cast<Uint8>(pixel);
+					p[1] = static_cast<Uint8>(pixel >> 8);
+					p[2] = static_cast<Uint8>(pixel >> 16);
+#endif
+				}
+				break;
+
+			default:
+				std::fill(reinterpret_cast<Uint32*>(row) + begin, reinterpret_cast<Uint32*>(row) + end, pixel);
+				break;
+		}
+	}
+
+	void TiledRenderer::DrawTile(const unsigned long tile, const SDL_Surface* const background,
+		SDL_Surface* const target) const
+	{
+		const unsigned int bytesPerPixel = target->format->BytesPerPixel;
+		const long left = (tile % tileColumns) * tileSize;
+		const long top = (tile / tileColumns) * tileSize;
+		const long right = std::min<long>(left + tileSize, target->w);
+		const long bottom = std::min<long>(top + tileSize, target->h);
+
+		Uint8* const pixels = static_cast<Uint8*>(target->pixels);
+		const Uint8* const backgroundPixels = static_cast<const Uint8*>(background->pixels);
+
+		for(long y = top; y < bottom; ++y)
+			memcpy(pixels + y * target->pitch + left * bytesPerPixel,
+				backgroundPixels + y * background->pitch + left * bytesPerPixel, (right - left) * bytesPerPixel);
+
+		const std::vector<boost::uint32_t>& bin = bins[tile];
+		for(std::vector<boost::uint32_t>::const_iterator i = bin.begin(), end = bin.end(); i != end; ++i)
+		{
+			const Fill& fill = fills[*i];
+			const long x0 = std::max<long>(fill.bounds.min.x, left);
+			const long x1 = std::min<long>(fill.bounds.max.x, right);
+			const long y1 = std::min<long>(fill.bounds.max.y, bottom);
+
+			for(long y = std::max<long>(fill.bounds.min.y, top); y < y1; ++y)
+				fill_span(pixels + y * target->pitch, x0, x1, fill.pixel, bytesPerPixel);
+		}
+	}
+
+	void TiledRenderer::Update(const UniqueObjectCollection& graphicsObjects, const EntityStore& entities,
+		Background& background, const Camera& camera, const Screen& target)
+	{
+		PROFILESCOPE(graphicsUpdate)
+
+		background.Refresh(graphicsObjects, camera, target);
+
+		SDL_Surface* const surface = target.GetSurface();
+		SDL_Surface* const backgroundSurface = background.GetScreen().GetSurface();
+
+		const unsigned long columns = (surface->w + tileSize - 1) / tileSize;
+		const unsigned long rows = (surface->h + tileSize - 1) / tileSize;
+		if(columns != tileColumns || rows != tileRows)
+		{
+			tileColumns = columns;
+			tileRows = rows;
+			bins.assign(columns * rows, std::vector<boost::uint32_t>());
+		}
+
+		// the bins keep their capacity from frame to frame
+		fills.clear();
+		for(std::vector<std::vector<boost::uint32_t> >::iterator i = bins.begin(), end = bins.end(); i != end; ++i)
+			i->clear();
+		for(std::vector<Palette::Index>::const_iterator i = mappedColors.begin(), end = mappedColors.end(); i != end; ++i)
+			paletteMapped[*i] = false;
+		mappedColors.clear();
+
+		// the same rectangles, in the same order, as Graphics::Update
+		const Bounds view = camera.GetView();
+		const EntityStore::BoundsArray& bounds = entities.GetBounds();
+		const EntityStore::ColorArray& colors = entities.GetColors();
+		for(EntityStore::Index i = 0, count = entities.GetCount(); i < count; ++i)
+			if(bounds[i].Overlaps(view))
+				AddFill(target.Clip(camera.ToScreen(bounds[i])), GetPixel(colors[i], surface));
+
+		for(UniqueObjectCollection::const_iterator i = graphicsObjects.begin(), end = graphicsObjects.end(); i != end; ++i)
+		{
+			const Bounds objectBounds = (*i)->GetBounds();
+			if((*i)->GetObjectType() != WorldObject::wall && objectBounds.Overlaps(view))
+				AddFill(target.Clip(camera.ToScreen(objectBounds)), GetPixel((*i)->GetColor(), surface));
+		}
+
+		if(SDL_LockSurface(surface) != 0)
+			Logger::Fatal(boost::format("Error drawing to screen: %1%") % SDL_GetError());
+
+		for(unsigned long tile = 0; tile < bins.size(); ++tile)
+			pool.Submit(boost::bind(&TiledRenderer::DrawTile, this, tile, backgroundSurface, surface));
+		pool.Wait();
+
+		SDL_UnlockSurface(surface);
+
+		SDL_FreeSurface(backgroundSurface);
+		SDL_FreeSurface(surface);
+
+		target.Update();
+	}
+}
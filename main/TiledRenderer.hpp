@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Bounds.hpp"
+#include "Palette.hpp"
+#include "ThreadPool.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <SDL_types.h>
+#include <SDL_video.h>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+class EntityStore;
+class Screen;
+class UniqueObjectCollection;
+
+namespace Graphics
+{
+	class Background;
+	class Camera;
+
+	// Draws exactly what Graphics::Update does, pixel for pixel, but in parallel. The screen is split
+	// into square tiles, every rectangle is binned into the tiles it touches, and the tiles are filled
+	// on worker threads, straight into the screen's pixels. Each tile draws its bin in order, so
+	// overlaps come out the same as drawing everything in order.
+	class TiledRenderer : private boost::noncopyable
+	{
+	public:
+		static const unsigned long defaultTileSize = 64;
+
+	private:
+		// a rectangle (already clipped to the screen) and the pixel value to fill it with
+		struct Fill
+		{
+			Bounds bounds;
+			Uint32 pixel;
+		};
+
+		ThreadPool pool;
+		const unsigned long tileSize;
+		// the screen size the bins are laid out for, in tiles
+		unsigned long tileColumns, tileRows;
+
+		// this frame's rectangles, in drawing order
+		std::vector<Fill> fills;
+		// the indices in _fills_ of the rectangles touching each tile, row by row
+		std::vector<std::vector<boost::uint32_t> > bins;
+
+		// each palette color mapped to the screen's pixel format, once it's been used this frame
+		std::vector<Uint32> palettePixels;
+		std::vector<bool> paletteMapped;
+		// the colors set in _paletteMapped_, so that only they have to be cleared for the next frame
+		std::vector<Palette::Index> mappedColors;
+
+		// the pixel value of palette color _color_ on _surface_
+		Uint32 GetPixel(Palette::Index color, const SDL_Surface* surface);
+		// queue _bounds_ to be filled with _pixel_, binning it into the tiles it touches
+		void AddFill(const Bounds& bounds, Uint32 pixel);
+		// copy tile _tile_ from _background_ onto _target_, then fill its bin over it
+		void DrawTile(unsigned long tile, const SDL_Surface* background, SDL_Surface* target) const;
+
+	public:
+		// draw on _threadCount_ threads, in tiles _tileSize_ pixels square
+		explicit TiledRenderer(unsigned long threadCount, unsigned long tileSize = defaultTileSize);
+
+		// draw _background_, then _entities_, then everything else in _graphicsObjects_ over them, as seen
+		// by _camera_. Anything out of view is skipped.
+		void Update(const UniqueObjectCollection& graphicsObjects, const EntityStore& entities, Background& background,
+			const Camera& camera, const Screen& target);
+	};
+}
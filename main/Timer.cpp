@@ -1,19 +1,20 @@
 #include "Timer.hpp"
 
-Timer::Timer()
+Timer::Timer(const Clock& _clock) :
+	clock(&_clock)
 {
 	Reset();
 }
 
 void Timer::Reset()
 {
-	lastTime = Clock::Get().GetTime();
+	lastTime = clock->GetTime();
 	elapsed = 0;
 }
 
 bool Timer::ResetIfHasElapsed(const Clock::TimeType c)
 {
-	const Clock::TimeType currentTime = Clock::Get().GetTime();
+	const Clock::TimeType currentTime = clock->GetTime();
 	const Clock::TimeType deltaT = currentTime - lastTime;
 	elapsed += deltaT;
 	lastTime = currentTime;
@@ -26,3 +27,13 @@ bool Timer::ResetIfHasElapsed(const Clock::TimeType c)
 
 	return false;
 }
+
+Clock::TimeType Timer::Lap()
+{
+	const Clock::TimeType currentTime = clock->GetTime();
+	const Clock::TimeType lap = elapsed + (currentTime - lastTime);
+	lastTime = currentTime;
+	elapsed = 0;
+
+	return lap;
+}
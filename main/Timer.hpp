@@ -2,20 +2,30 @@
 
 #include "Clock.hpp"
 
-// basic functionality for checking if intervals have elapsed
+// basic functionality for checking if intervals of _clock_'s time have elapsed
 class Timer
 {
 private:
+	const Clock* clock;
 	// the time, last time the time was checked
 	Clock::TimeType lastTime;
 	// the amount of time elapsed
 	Clock::TimeType elapsed;
 
 public:
-	Timer();
+	explicit Timer(const Clock& clock);
 	void Reset();
 	// if at least _count_ has elapsed, reset the counter
 	// (accounting for overflow if more than _count_ has elapsed).
 	// Returns true if the counter was reset, false otherwise.
 	bool ResetIfHasElapsed(Clock::TimeType ms);
+	// return the time elapsed since the last reset (or lap), and reset
+	Clock::TimeType Lap();
+
+	// read or write this timer's state through _archive_ (see GameWorld::SaveSnapshot)
+	template <typename Archive>
+	void Serialize(Archive& archive)
+	{
+		archive & lastTime & elapsed;
+	}
 };
@@ -0,0 +1,112 @@
+#include "Tracer.hpp"
+
+#ifdef TRACING
+
+#include "Logger.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdio>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Tracer
+{
+	// must be a power of 2
+	static const unsigned long eventCapacity = 1 << 18;
+	static const unsigned int maxThreads = 64;
+
+	struct Event
+	{
+		Profiler::TimeType start;
+		Profiler::TimeType duration;
+		unsigned short section;
+		unsigned short thread;
+	};
+
+	static Event events[eventCapacity];
+	// total number of events ever recorded; the next event goes in events[eventCount % eventCapacity]
+	static boost::atomic<unsigned long> eventCount(0);
+
+	static const char* threadNames[maxThreads];
+	static boost::atomic<unsigned int> threadCount(0);
+
+	// the calling thread's index in _threadNames_
+	static boost::thread_specific_ptr<unsigned int> currentThread;
+
+	static unsigned int get_thread()
+	{
+		unsigned int* thread = currentThread.get();
+		if(thread == NULL)
+		{
+			// threads past the limit share the last slot
+			thread = new unsigned int(std::min(threadCount++, maxThreads - 1));
+			currentThread.reset(thread);
+		}
+
+		return *thread;
+	}
+
+	void NameThread(const char* const name)
+	{
+		threadNames[get_thread()] = name;
+	}
+
+	void Record(const Profiler::Section section, const Profiler::TimeType start, const Profiler::TimeType duration)
+	{
+		Event& event = events[eventCount.fetch_add(1, boost::memory_order_relaxed) & (eventCapacity - 1)];
+		event.start = start;
+		event.duration = duration;
+		event.section = section;
+		event.thread = get_thread();
+	}
+
+	void Dump(const char* const filename)
+	{
+		FILE* const file = fopen(filename, "w");
+		if(file == NULL)
+		{
+			LOGDEBUG(boost::format("Unable to open trace dump \"%1%\"") % filename)
+			return;
+		}
+
+		const unsigned long count = eventCount.load();
+		const unsigned long first = (count > eventCapacity) ? count - eventCapacity : 0;
+		const unsigned int threads = std::min(threadCount.load(), maxThreads);
+
+		// make timestamps relative to the earliest event
+		Profiler::TimeType origin = ~Profiler::TimeType(0);
+		for(unsigned long i = first; i < count; ++i)
+			origin = std::min(origin, events[i & (eventCapacity - 1)].start);
+
+		fprintf(file, "{\"traceEvents\":[\n");
+		const char* separator = "";
+		for(unsigned int thread = 0; thread < threads; ++thread, separator = ",\n")
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				separator, thread, threadNames[thread] ? threadNames[thread] : "unnamed");
+
+		for(unsigned long i = first; i < count; ++i, separator = ",\n")
+		{
+			const Event& event = events[i & (eventCapacity - 1)];
+			const Profiler::Section section = static_cast<Profiler::Section>(event.section);
+			const bool lockWait = (section >= Profiler::graphicsLockWait);
+
+			fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu}",
+				separator, Profiler::GetSectionName(section), lockWait ? "lock" : "update", event.thread,
+				static_cast<unsigned long long>(event.start - origin),
+				static_cast<unsigned long long>(event.duration));
+		}
+
+		fprintf(file, "\n]}\n");
+		fclose(file);
+	}
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+// Thread timeline tracing, in the Chrome/Perfetto trace event format (load the dump in
+// chrome://tracing or ui.perfetto.dev). Events come from the Profiler's instrumentation
+// points, and are kept in a fixed-size ring buffer, so only the most recent ones survive.
+// Unless TRACING is defined, none of this is compiled in.
+
+#include "Profiler.hpp"
+
+#ifdef TRACING
+
+namespace Tracer
+{
+	// name the calling thread in the timeline
+	void NameThread(const char* name);
+
+	// add an event to the timeline for the calling thread
+	void Record(Profiler::Section section, Profiler::TimeType start, Profiler::TimeType duration);
+
+	// write the buffered events to _filename_ as JSON
+	void Dump(const char* filename);
+}
+
+#define TRACEDUMP(filename) Tracer::Dump(filename);
+
+#else
+
+#define TRACEDUMP(filename)
+
+#endif
@@ -2,18 +2,20 @@
 
 #include "custom_algorithm.hpp"
 #include "Logger.hpp"
+#include "WorldObject.hpp"
 
 static inline bool object_exists(const UniqueObjectCollection::CollectionType& list, const WorldObject* const val)
 {
 	return in(list.begin(), list.end(), val);
 }
 
-UniqueObjectCollection::UniqueObjectCollection()
+UniqueObjectCollection::UniqueObjectCollection() :
+	wallsVersion(0)
 {
 }
 
 UniqueObjectCollection::UniqueObjectCollection(const UniqueObjectCollection& obj) :
-	objects(obj.objects)
+	objects(obj.objects), wallsVersion(obj.wallsVersion)
 {
 }
 
@@ -40,15 +42,32 @@ UniqueObjectCollection::const_iterator UniqueObjectCollection::end() const
 void UniqueObjectCollection::Add(WorldObject& obj)
 {
 	if(object_exists(objects, &obj))
-		Logger::Debug(boost::format("Object %1% already exists.") % &obj);
+		LOGDEBUG(boost::format("Object %1% already exists.") % &obj)
 
 	objects.push_back(&obj);
+
+	if(obj.GetObjectType() == WorldObject::wall)
+		++wallsVersion;
 }
 
 void UniqueObjectCollection::Remove(WorldObject& obj)
 {
 	if(!object_exists(objects, &obj))
-		Logger::Debug(boost::format("Object %1% does not exist.") % &obj);
+		LOGDEBUG(boost::format("Object %1% does not exist.") % &obj)
 
 	unordered_find_and_remove(objects, &obj);
+
+	if(obj.GetObjectType() == WorldObject::wall)
+		++wallsVersion;
+}
+
+void UniqueObjectCollection::Clear()
+{
+	objects.clear();
+	++wallsVersion;
+}
+
+unsigned long UniqueObjectCollection::GetWallsVersion() const
+{
+	return wallsVersion;
 }
@@ -26,6 +26,9 @@ public:
 
 private:
 	CollectionType objects;
+	// changed whenever a wall is added or removed, so that anything drawn from the walls can tell when
+	// it's out of date
+	unsigned long wallsVersion;
 
 public:
 	RecursiveMutex mutex;
@@ -35,6 +38,9 @@ public:
 
 	void Add(WorldObject&);
 	void Remove(WorldObject&);
+	void Clear();
+
+	unsigned long GetWallsVersion() const;
 
 	iterator begin();
 	const_iterator begin() const;
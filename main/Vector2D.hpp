@@ -1,18 +1,85 @@
 #pragma once
+// The geometry types (Vector2D, Direction, Line and Bounds) are used by every movement and
+// collision test in the game, so they're all defined inline, in their headers.
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
 
 // 2D vector class
 struct Vector2D
 {
-	long x, y;
+	// 32 bits is plenty for pixels, and keeps the world objects small
+	typedef boost::int32_t Coordinate;
+
+	Coordinate x, y;
 
 	Vector2D();
-	Vector2D(long x, long y);
+	Vector2D(Coordinate x, Coordinate y);
 
 	Vector2D& operator+=(Vector2D);
+	Vector2D operator+(Vector2D) const;
 	Vector2D operator-(Vector2D) const;
 	Vector2D operator-() const;
-	Vector2D operator*(long scale) const;
+	Vector2D operator*(Coordinate scale) const;
 
 	bool operator==(Vector2D) const;
 	bool operator!=(Vector2D) const;
 };
+
+BOOST_STATIC_ASSERT(sizeof(Vector2D) == 8);
+
+inline Vector2D::Vector2D() :
+	x(0), y(0)
+{
+}
+
+inline Vector2D::Vector2D(const Coordinate _x, const Coordinate _y) :
+	x(_x), y(_y)
+{
+}
+
+inline Vector2D& Vector2D::operator+=(const Vector2D obj)
+{
+	x += obj.x;
+	y += obj.y;
+
+	return *this;
+}
+
+inline Vector2D Vector2D::operator+(const Vector2D obj) const
+{
+	return Vector2D(x + obj.x, y + obj.y);
+}
+
+inline Vector2D Vector2D::operator-(const Vector2D obj) const
+{
+	return Vector2D(x - obj.x, y - obj.y);
+}
+
+inline Vector2D Vector2D::operator-() const
+{
+	return Vector2D(-x, -y);
+}
+
+inline Vector2D Vector2D::operator*(const Coordinate scale) const
+{
+	return Vector2D(x * scale, y * scale);
+}
+
+inline bool Vector2D::operator==(const Vector2D obj) const
+{
+	return ((x == obj.x) && (y == obj.y));
+}
+
+inline bool Vector2D::operator!=(const Vector2D obj) const
+{
+	return !(*this == obj);
+}
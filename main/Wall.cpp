@@ -1,12 +1,11 @@
 #include "Wall.hpp"
 
 Wall::Wall(const Bounds& _bounds, const Color24 color) :
-	WorldObject(wall, color)
+	WorldObject(wall, color), bounds(_bounds)
 {
-	bounds = _bounds;
 }
 
-void Wall::CollisionHandler(WorldObject& obj) const
+Bounds Wall::GetBounds() const
 {
-	obj.CollisionHandler(*this);
+	return bounds;
 }
@@ -4,8 +4,14 @@
 
 class Wall : public WorldObject
 {
+private:
+	Bounds bounds;
+
 public:
 	Wall(const Bounds& wallBounds, Color24);
 
-	void CollisionHandler(WorldObject&) const;
+	Bounds GetBounds() const;
 };
+
+// a WorldObject and its bounds
+BOOST_STATIC_ASSERT(sizeof(Wall) <= 2 * sizeof(void*) + sizeof(Bounds));
@@ -2,14 +2,28 @@
 
 #include "Bounds.hpp"
 #include "Color24.hpp"
-#include "Mutex.hpp"
+#include "Palette.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/static_assert.hpp>
+#include <SDL_types.h>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
 
-class Food;
-class Mine;
 class Screen;
-class SnakeSegment;
-class Wall;
 
+namespace Graphics
+{
+	class Camera;
+}
+
+// World objects have no locks of their own. They're only changed by their world's thread, which holds
+// the graphics collection's lock while it moves anything that's being drawn.
 class WorldObject
 {
 public:
@@ -23,29 +37,35 @@ public:
 	};
 
 private:
-	ObjectType type;
+	// an ObjectType, in a byte
+	Uint8 type;
 
 protected:
-	Color24 color;
-	// the rectangular bounds of this object
-	Bounds bounds;
+	Palette::Index color;
 
-public:
-	RecursiveMutex mutex;
+	// read or write this object's color through _archive_. Palette indices depend on
+	// the order colors were first used in, so the color itself is stored.
+	template <typename Archive>
+	void SerializeColor(Archive& archive)
+	{
+		Color24 rgb = Palette::GetColor(color);
+		archive & rgb.r & rgb.g & rgb.b;
+		color = Palette::GetIndex(rgb);
+	}
 
+public:
 	WorldObject(ObjectType);
 	WorldObject(ObjectType, const Color24 color);
 	virtual ~WorldObject();
-	
-	virtual void CollisionHandler(WorldObject&) const;
-	virtual void CollisionHandler(const Food&);
-	virtual void CollisionHandler(const Mine&);
-	virtual void CollisionHandler(const SnakeSegment&);
-	virtual void CollisionHandler(const Wall&);
-	
+
 	ObjectType GetObjectType() const;
-	Bounds GetBounds() const;
+	Palette::Index GetColor() const;
+	// the rectangular bounds of this object
+	virtual Bounds GetBounds() const = 0;
 
-	// draw this object to _target_
-	void Draw(const Screen& target) const;
+	// draw this object to _target_, as seen by _camera_
+	void Draw(const Screen& target, const Graphics::Camera& camera) const;
 };
+
+// the vtable pointer, with the type and color packed in after it
+BOOST_STATIC_ASSERT(sizeof(WorldObject) <= 2 * sizeof(void*));
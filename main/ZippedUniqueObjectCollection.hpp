@@ -1,11 +1,14 @@
 #pragma once
 
+#include "Bounds.hpp"
+#include "EntityStore.hpp"
+#include "Profiler.hpp"
 #include "UniqueObjectCollection.hpp"
 
 // do _stuffToDo_ while _obj_'s internal mutexes are locked
 #define DOLOCKEDZ(obj, stuffToDo) \
-	DOLOCKED(obj.graphics.mutex, \
-		DOLOCKED(obj.physics.mutex, \
+	DOLOCKEDP(graphicsLockWait, obj.graphics.mutex, \
+		DOLOCKEDP(physicsLockWait, obj.physics.mutex, \
 			stuffToDo \
 		) \
 	)
@@ -15,6 +18,15 @@ struct ZippedUniqueObjectCollection
 	// apply _func_ to _graphics_ and _physics_
 #define DOBOTH(func) graphics.func; physics.func;
 	UniqueObjectCollection graphics, physics;
+	// the spawns, which are both drawn and collided with (guarded by _graphics_' mutex)
+	EntityStore entities;
+	// the bounds of the snake's head, for the camera to follow (guarded by _graphics_' mutex)
+	Bounds focus;
+
+	inline ZippedUniqueObjectCollection() :
+		focus(Point(0, 0), Point(0, 0))
+	{
+	}
 
 	inline void Add(WorldObject& obj)
 	{
@@ -38,5 +50,11 @@ struct ZippedUniqueObjectCollection
 		DOBOTH(RemoveRange(begin, end))
 	}
 
+	inline void Clear()
+	{
+		DOBOTH(Clear())
+		entities.Clear();
+	}
+
 #undef DOBOTH
 };
@@ -6,7 +6,7 @@
 #endif
 
 #include <algorithm>
-#include <boost/bind/bind.hpp>
+#include <boost/bind.hpp>
 #include <cassert>
 #include <functional>
 #include <vector>
@@ -1,23 +1,36 @@
+#include "Camera.hpp"
 #include "Clock.hpp"
 #include "Common.hpp"
 #include "Config.hpp"
 #include "EventHandler.hpp"
+#include "FileWatcher.hpp"
 #include "GameWorld.hpp"
 #include "Graphics.hpp"
+#include "InputRecorder.hpp"
 #include "Logger.hpp"
 #include "Music.hpp"
-#include "Physics.hpp"
+#include "Profiler.hpp"
 #include "Screen.hpp"
 #include "SDLInitializer.hpp"
+#include "TiledRenderer.hpp"
 #include "Timer.hpp"
+#include "Tracer.hpp"
 #include "ZippedUniqueObjectCollection.hpp"
 
 #ifdef MSVC
 #pragma warning(push, 0)
 #endif
 
+#include <algorithm>
+#include <boost/atomic.hpp>
 #include <boost/bind.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread.hpp>
+#include <ctime>
+#include <fstream>
+#include <iostream>
 #include <list>
 #include <memory>
 #include <SDL.h>
@@ -27,16 +40,37 @@
 #endif
 
 static EventHandler::QuitCallbackType quit_handler;
-static EventHandler::LossCallbackType loss_handler;
 static EventHandler::PauseCallbackType default_pause_handler;
 static EventHandler::PauseCallbackType paused_pause_handler;
-static EventHandler::SoundCallbackType sound_handler;
 static EventHandler::KeyCallbackType default_key_handler;
 static EventHandler::KeyCallbackType paused_key_handler;
 static EventHandler::MouseCallbackType default_mouse_handler;
 static EventHandler::MouseCallbackType paused_mouse_handler;
 
 static const char* windowTitle("ReWritable's Snake");
+static const char* const defaultConfigFilename = "game.cfg";
+// the most real time the game thread will catch up on at once; any more (e.g. after a stall) is skipped
+static const Uint32 maxLag = 100;
+// how much game time passes between checkpoints (see --checkpoint)
+static const Clock::TimeType checkpointPeriod = 10 * 1000;
+
+// the command-line options (see parse_arguments)
+struct Arguments
+{
+	std::string configFilename;
+	std::string logFilename;
+	std::string recordingFilename;
+	std::string restoreFilename;
+	std::string checkpointFilename;
+	// 0 to draw on the main thread
+	unsigned long renderThreads;
+};
+static Arguments arguments;
+
+// the config as the main thread sees it (the game world has its own copy)
+static boost::shared_ptr<const Config> config;
+// set by the main thread, and read by the game world's thread when it plays a sound
+static boost::atomic<bool> soundEnabled(false);
 static std::auto_ptr<ZippedUniqueObjectCollection> gameObjects;
 static std::auto_ptr<GameWorld> gameWorld;
 
@@ -44,23 +78,57 @@ typedef std::list<std::string> SoundQueue;
 static Mutex soundMutex;
 static SoundQueue soundQueue;
 
-// returns false iff loading failed
-static void physics_loop();
+typedef std::list<Sound> SoundCollection;
+
+#ifdef PROFILING
+static const char* const profileFilename = "profile.txt";
+#endif
+#ifdef TRACING
+static const char* const traceFilename = "trace.json";
+#endif
+
+static bool parse_arguments(int argc, char* argv[]);
+static void open_log(const std::string& logFilename);
+static void pump_sounds(SoundCollection& sounds);
+static void reload_config(const std::string& configFilename, std::auto_ptr<const Music>& music);
+static void restore_snapshot(const std::string& snapshotFilename);
+static void save_checkpoint(const std::string& checkpointFilename);
+static void start_music(std::auto_ptr<const Music>& music);
+
 static void game_loop();
 
-static const EventHandler defaultEventHandler(quit_handler, loss_handler, default_pause_handler,
-	sound_handler, default_key_handler, default_mouse_handler);
+// the game world's callbacks
+static void loss_handler();
+static void sound_handler(const std::string& filename);
+
+static const EventHandler defaultEventHandler(quit_handler, default_pause_handler, default_key_handler,
+	default_mouse_handler);
 
-static const EventHandler pausedEventHandler(quit_handler, loss_handler, paused_pause_handler,
-	sound_handler, paused_key_handler, paused_mouse_handler);
+static const EventHandler pausedEventHandler(quit_handler, paused_pause_handler, paused_key_handler,
+	paused_mouse_handler);
 
-bool quit, lost, paused;
+bool quit, paused;
 
-int main(int, char*[])
+// usage: GingerbreadPrototype [config file] [options] (see --help)
+int main(int argc, char* argv[])
 {
-	typedef std::list<Sound> SoundCollection;
+	PROFILETHREAD("main")
+
+	if(!parse_arguments(argc, argv))
+		return 0;
+
+	const std::string& configFilename = arguments.configFilename;
+	const std::string& recordingFilename = arguments.recordingFilename;
+
+	if(!arguments.logFilename.empty())
+		open_log(arguments.logFilename);
+
+	config = boost::shared_ptr<const Config>(new Config(Config::GetConfigLoader(configFilename)));
+	soundEnabled = config->sound;
+	FileWatcher configWatcher(configFilename);
+
 	SoundCollection sounds;
-	quit = lost = paused = false;
+	quit = paused = false;
 
 	SDLInitializer keepSDLInitialized;
 
@@ -68,7 +136,23 @@ int main(int, char*[])
 	SDL_ShowCursor(SDL_DISABLE);
 
 	gameObjects = std::auto_ptr<ZippedUniqueObjectCollection>(new ZippedUniqueObjectCollection());
-	gameWorld = std::auto_ptr<GameWorld>(new GameWorld(*gameObjects));
+	const unsigned long seed = static_cast<unsigned long>(time(NULL));
+	gameWorld = std::auto_ptr<GameWorld>(new GameWorld(config, *gameObjects, seed));
+	gameWorld->SetCallbacks(&sound_handler, &loss_handler);
+
+	if(!arguments.restoreFilename.empty())
+		restore_snapshot(arguments.restoreFilename);
+
+	std::auto_ptr<InputRecorder> recorder;
+	if(!recordingFilename.empty())
+	{
+		recorder = std::auto_ptr<InputRecorder>(new InputRecorder(recordingFilename, seed, GameWorld::tickLength));
+		if(!recorder->IsGood())
+			Logger::Fatal(boost::format("Unable to open recording \"%1%\"") % recordingFilename);
+
+		gameWorld->SetRecorder(recorder.get());
+		LOGDEBUG(boost::format("Recording to \"%1%\" (seed %2%)") % recordingFilename % seed)
+	}
 
 	DOLOCKED(EventHandler::mutex,
 		EventHandler::Get() = &defaultEventHandler;
@@ -76,80 +160,224 @@ int main(int, char*[])
 
 	Mix_AllocateChannels(10);
 
-	const Music music(Config::Get().resources.theme);
+	std::auto_ptr<const Music> music;
+	start_music(music);
 	
-	Timer screenUpdate;
-	const Screen screen(Config::Get().screen.w, Config::Get().screen.h);
+	Timer screenUpdate(gameWorld->GetClock());
+	const Screen screen(config->screen.w, config->screen.h, config->screen.bgColor);
+	Graphics::Background background;
+	Graphics::Camera camera(screen.GetBounds());
+	std::auto_ptr<Graphics::TiledRenderer> tiledRenderer;
+	if(arguments.renderThreads > 0)
+		tiledRenderer = std::auto_ptr<Graphics::TiledRenderer>(new Graphics::TiledRenderer(arguments.renderThreads));
 
-	boost::thread physicsThread(physics_loop);
 	boost::thread gameThread(game_loop);
 
 	while(!quit)
 	{
-		if(screenUpdate.ResetIfHasElapsed(1000 / Config::Get().FPS))
+		if(screenUpdate.ResetIfHasElapsed(1000 / config->FPS))
 		{
-			DOLOCKED(gameObjects->graphics.mutex,
-				Graphics::Update(gameObjects->graphics, screen);
+			DOLOCKEDP(graphicsLockWait, gameObjects->graphics.mutex,
+				camera.Follow(gameObjects->focus, Point(config->world.w, config->world.h));
+
+				if(tiledRenderer.get() != NULL)
+					tiledRenderer->Update(gameObjects->graphics, gameObjects->entities, background, camera, screen);
+				else
+					Graphics::Update(gameObjects->graphics, gameObjects->entities, background, camera, screen);
 			)
 		}
 
-		DOLOCKED(soundMutex,
-			if(sounds.size() > 0)
-				if(sounds.front().IsDone())
-					sounds.pop_front();
-
-			if(soundQueue.size() > 0)
-			{
-				sounds.push_back(Sound(soundQueue.front()));
-				soundQueue.pop_front();
-			}
-		)
+		pump_sounds(sounds);
 
-		DOLOCKED(EventHandler::mutex,
+		DOLOCKEDP(eventHandlerLockWait, EventHandler::mutex,
 			EventHandler::Get()->HandleEventQueue();
 		)
+
+		if(configWatcher.HasChanged())
+			reload_config(configFilename, music);
+
+		PROFILEDUMPIFDUE(profileFilename)
 	}
 
 	// wait for everything to complete
-	physicsThread.join();
 	gameThread.join();
 
+	if(recorder.get() != NULL && !recorder->IsGood())
+		LOGDEBUG(boost::format("Writing the recording \"%1%\" failed; it's incomplete") % recordingFilename)
+
 	for_each(sounds.begin(), sounds.end(), boost::bind(&Sound::Stop, _1));
 	sounds.clear();
 
+	PROFILEDUMP(profileFilename)
+	TRACEDUMP(traceFilename)
+
 	return 0;
 }
 
-static void physics_loop()
+// fill in _arguments_. Returns false iff the game shouldn't be run (e.g. only help was asked for).
+static bool parse_arguments(const int argc, char* argv[])
 {
-	while(!quit)
+	namespace po = boost::program_options;
+
+	po::options_description options("Options");
+	options.add_options()
+		("help", "show this message")
+		("config", po::value(&arguments.configFilename)->default_value(defaultConfigFilename), "the game config")
+		("log", po::value(&arguments.logFilename), "log to this file instead of stdout; as JSON lines if it ends in "
+			"\".jsonl\", in binary if it ends in \".bin\", or as text otherwise")
+		("record", po::value(&arguments.recordingFilename), "record the game's seed and inputs to this file, "
+			"to be replayed with snake_replay")
+		("restore", po::value(&arguments.restoreFilename), "start from a snapshot of a game, written by "
+			"--checkpoint (with the same config)")
+		("checkpoint", po::value(&arguments.checkpointFilename), "write a snapshot of the game to this file "
+			"every 10s of game time")
+		("render-threads", po::value(&arguments.renderThreads)->default_value(0), "draw each frame in tiles, "
+			"on this many threads (for large screens), instead of all on the main thread");
+
+	po::positional_options_description positional;
+	positional.add("config", 1);
+
+	po::variables_map values;
+	try
 	{
-		DOLOCKED(gameObjects->physics.mutex,
-			Physics::Update(*gameWorld, gameObjects->physics);
-		)
-		SDL_Delay(5);
+		po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), values);
+		po::notify(values);
 	}
+	catch(const po::error& e)
+	{
+		Logger::Fatal(e.what());
+	}
+
+	if(values.count("help"))
+	{
+		std::cout << "usage: " << argv[0] << " [config file] [options]\n" << options;
+		return false;
+	}
+
+	// a recording has to start from a fresh game, to be replayed
+	if(!arguments.restoreFilename.empty() && !arguments.recordingFilename.empty())
+		Logger::Fatal("A restored game can't be recorded");
+
+	return true;
+}
+
+static inline bool ends_with(const std::string& str, const std::string& suffix)
+{
+	return (str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+static void open_log(const std::string& logFilename)
+{
+	Logger::Format format = Logger::text;
+	if(ends_with(logFilename, ".jsonl"))
+		format = Logger::jsonLines;
+	else if(ends_with(logFilename, ".bin"))
+		format = Logger::binary;
+
+	if(!Logger::Open(logFilename.c_str(), format))
+		Logger::Fatal(boost::format("Unable to open log file \"%1%\"") % logFilename);
+}
+
+// retire finished sounds, and start queued ones
+static void pump_sounds(SoundCollection& sounds)
+{
+	PROFILESCOPE(soundPump)
+
+	DOLOCKEDP(soundLockWait, soundMutex,
+		if(sounds.size() > 0)
+			if(sounds.front().IsDone())
+				sounds.pop_front();
+
+		if(soundQueue.size() > 0)
+		{
+			sounds.push_back(Sound(soundQueue.front()));
+			soundQueue.pop_front();
+		}
+	)
+}
+
+// (re)start the theme music, if music is on
+static void start_music(std::auto_ptr<const Music>& music)
+{
+	music.reset();
+	if(config->music)
+		music = std::auto_ptr<const Music>(new Music(config->resources.theme));
+}
+
+// reparse the config, and hand it over to the game world to apply at its next tick
+static void reload_config(const std::string& configFilename, std::auto_ptr<const Music>& music)
+{
+	// the file can be briefly missing while an editor replaces it; wait for the next change
+	if(!boost::filesystem::exists(configFilename))
+		return;
+
+	const boost::shared_ptr<const Config> oldConfig = config;
+	config = boost::shared_ptr<const Config>(new Config(Config::GetConfigLoader(configFilename)));
+	soundEnabled = config->sound;
+
+	if(config->music != oldConfig->music || config->resources.theme != oldConfig->resources.theme)
+		start_music(music);
+
+	if(config->screen.w != oldConfig->screen.w || config->screen.h != oldConfig->screen.h)
+		LOGDEBUG("Screen size changes only take effect after a restart")
+
+	gameWorld->SetConfig(config);
 }
 
+// replace the new game with the one in _snapshotFilename_
+static void restore_snapshot(const std::string& snapshotFilename)
+{
+	std::ifstream snapshot(snapshotFilename.c_str(), std::ios::binary);
+	if(!snapshot.is_open() || !gameWorld->LoadSnapshot(snapshot))
+		Logger::Fatal(boost::format("Unable to restore \"%1%\"") % snapshotFilename);
+
+	LOGDEBUG(boost::format("Restored \"%1%\" (tick %2%)") % snapshotFilename % gameWorld->GetTick())
+}
+
+// write a snapshot of the game to _checkpointFilename_. It's written to a temporary file first, so
+// there's always a whole checkpoint there, even if the game dies while writing one.
+static void save_checkpoint(const std::string& checkpointFilename)
+{
+	const std::string temporaryFilename = checkpointFilename + ".tmp";
+
+	std::ofstream snapshot(temporaryFilename.c_str(), std::ios::binary);
+	gameWorld->SaveSnapshot(snapshot);
+	snapshot.close();
+
+	boost::system::error_code error;
+	if(snapshot)
+		boost::filesystem::rename(temporaryFilename, checkpointFilename, error);
+
+	if(!snapshot || error)
+		LOGDEBUG(boost::format("Unable to write checkpoint \"%1%\"") % checkpointFilename)
+}
+
+// step the game world in time with the real clock, catching up (to a point) if it falls behind
 static void game_loop()
 {
+	PROFILETHREAD("game")
+
+	// real time which hasn't been simulated yet
+	Uint32 lag = 0;
+	Uint32 lastTime = SDL_GetTicks();
+	Timer checkpointTimer(gameWorld->GetClock());
+
 	while(!quit)
 	{
-		while(!lost && !quit)
-		{
-			if(!paused)
-				gameWorld->Update();
+		const Uint32 now = SDL_GetTicks();
+		if(!paused)
+			lag = std::min(lag + (now - lastTime), maxLag);
+		lastTime = now;
 
-			SDL_Delay(5);
-		}
-		if(lost)
-		{
-			Logger::Debug("DEATH");
-			gameWorld->Reset();
-			lost = false;
-		}
+		for(; lag >= GameWorld::tickLength; lag -= GameWorld::tickLength)
+			gameWorld->Step();
+
+		if(!arguments.checkpointFilename.empty() && checkpointTimer.ResetIfHasElapsed(checkpointPeriod))
+			save_checkpoint(arguments.checkpointFilename);
+
+		SDL_Delay(1);
 	}
-	Logger::Debug("Quit called");
+	LOGDEBUG("Quit called")
 }
 
 static void quit_handler()
@@ -157,9 +385,10 @@ static void quit_handler()
 	quit = true;
 }
 
+// the game world starts a new game by itself
 static void loss_handler()
 {
-	lost = true;
+	LOGDEBUG("DEATH")
 }
 
 static void default_pause_handler()
@@ -169,8 +398,7 @@ static void default_pause_handler()
 	)
 	Music::Pause();
 	paused = true;
-	Clock::Get().Pause();
-	Logger::Debug("Pausing");
+	LOGDEBUG("Pausing")
 }
 
 static void paused_pause_handler()
@@ -180,13 +408,15 @@ static void paused_pause_handler()
 	)
 	Music::Unpause();
 	paused = false;
-	Clock::Get().Unpause();
-	Logger::Debug("Resuming");
+	LOGDEBUG("Resuming")
 }
 
 static void sound_handler(const std::string& filename)
 {
-	DOLOCKED(soundMutex,
+	if(!soundEnabled)
+		return;
+
+	DOLOCKEDP(soundLockWait, soundMutex,
 		soundQueue.push_back(filename);
 	)
 }
@@ -0,0 +1,36 @@
+#include "benchmark.hpp"
+#include "../main/AliasTable.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// pick a spawn from _arg_ spawn types with uneven rates, and nothing the rest of the time
+static void bench_alias_table_sample(Benchmark::State& state)
+{
+	std::vector<double> rates;
+	double total = 0;
+	for(long i = 0; i < state.GetArg(); ++i)
+	{
+		rates.push_back(0.5 / state.GetArg() * (i % 3 + 1) / 2);
+		total += rates.back();
+	}
+	rates.push_back(1 - total);
+
+	const AliasTable table(rates);
+	Random random(42);
+
+	unsigned long picked = 0;
+	while(state.KeepRunning())
+		picked += table.Sample(random);
+
+	Benchmark::DoNotOptimize(picked);
+}
+BENCHMARK_ARG(bench_alias_table_sample, 10)
+BENCHMARK_ARG(bench_alias_table_sample, 1000)
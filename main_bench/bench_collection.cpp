@@ -0,0 +1,31 @@
+#include "benchmark.hpp"
+#include "../main/UniqueObjectCollection.hpp"
+#include "../main/Wall.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// add _arg_ objects to a collection, then remove them all
+static void bench_collection_add_remove(Benchmark::State& state)
+{
+	std::vector<Wall> walls(state.GetArg(), Wall(Bounds(Point(0, 0), Point(10, 10)), Color24()));
+
+	UniqueObjectCollection collection;
+	while(state.KeepRunning())
+	{
+		for(std::vector<Wall>::iterator i = walls.begin(), end = walls.end(); i != end; ++i)
+			collection.Add(*i);
+		for(std::vector<Wall>::iterator i = walls.begin(), end = walls.end(); i != end; ++i)
+			collection.Remove(*i);
+	}
+}
+BENCHMARK_ARG(bench_collection_add_remove, 10)
+BENCHMARK_ARG(bench_collection_add_remove, 100)
+BENCHMARK_ARG(bench_collection_add_remove, 1000)
@@ -0,0 +1,19 @@
+#include "benchmark.hpp"
+#include "../main/collision.h"
+
+static void bench_does_collide(Benchmark::State& state)
+{
+	ObjectBounds objects[4] = {
+		{{0, 0}, {10, 10}},
+		{{5, 5}, {15, 15}},
+		{{20, 0}, {30, 10}},
+		{{0, 20}, {10, 30}}
+	};
+
+	unsigned long hits = 0;
+	for(unsigned long i = 0; state.KeepRunning(); ++i)
+		hits += does_collide(&objects[i & 3], &objects[(i >> 2) & 3]);
+
+	Benchmark::DoNotOptimize(hits);
+}
+BENCHMARK(bench_does_collide)
@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+#include "../main/Config.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// a config with _count_ walls, in the style of game.cfg
+static std::string make_config(const long count)
+{
+	std::stringstream config;
+	config << "music 1\nsound 1\nFPS 60\n\n{ walls\n";
+	for(long i = 0; i < count; ++i)
+		config << "\t{ wall { bounds { min x " << i % 800 << " y " << i % 600
+			<< " } { max x " << i % 800 + 10 << " y " << i % 600 + 10
+			<< " } } { color r 255 g 0 b 0 } }\n";
+	config << "}\n";
+
+	return config.str();
+}
+
+// parse a config with _arg_ walls, and load the walls from it
+static void bench_config_parse(Benchmark::State& state)
+{
+	const std::string text = make_config(state.GetArg());
+
+	while(state.KeepRunning())
+	{
+		std::stringstream configInput(text);
+		const Config::ConfigScope config(configInput);
+		const Config::LoadableCollection<Config::WallConfig> walls("walls", "wall", &config);
+
+		Benchmark::DoNotOptimize(walls.list.size());
+	}
+}
+BENCHMARK_ARG(bench_config_parse, 10)
+BENCHMARK_ARG(bench_config_parse, 1000)
+BENCHMARK_ARG(bench_config_parse, 10000)
+
+// map in a compiled config with _arg_ walls, and load the walls from it
+static void bench_config_load_compiled(Benchmark::State& state)
+{
+	const char* const filename = "bench_config.cfgc";
+	{
+		std::ofstream output(filename, std::ios::binary);
+		Config::ConfigScope(make_config(state.GetArg())).WriteCompiled(output);
+	}
+
+	while(state.KeepRunning())
+	{
+		const std::auto_ptr<Config::ConfigScope> config(Config::ConfigScope::LoadCompiled(filename));
+		const Config::LoadableCollection<Config::WallConfig> walls("walls", "wall", config.get());
+
+		Benchmark::DoNotOptimize(walls.list.size());
+	}
+
+	remove(filename);
+}
+BENCHMARK_ARG(bench_config_load_compiled, 10)
+BENCHMARK_ARG(bench_config_load_compiled, 1000)
+BENCHMARK_ARG(bench_config_load_compiled, 10000)
@@ -0,0 +1,116 @@
+#include "benchmark.hpp"
+#include "../main/Camera.hpp"
+#include "../main/EntityStore.hpp"
+#include "../main/Graphics.hpp"
+#include "../main/Screen.hpp"
+#include "../main/TiledRenderer.hpp"
+#include "../main/UniqueObjectCollection.hpp"
+#include "../main/Wall.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/random.hpp>
+#include <boost/thread/thread.hpp>
+#include <SDL_video.h>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// _wallCount_ walls and _spawnCount_ spawns, scattered over a _width_ x _height_ world
+struct Scene
+{
+	std::vector<Wall> walls;
+	UniqueObjectCollection objects;
+	EntityStore entities;
+
+	Scene(const long width, const long height, const long wallCount, const long spawnCount)
+	{
+		boost::minstd_rand rand(42);
+		for(long i = 0; i < wallCount; ++i)
+		{
+			const Point min(rand() % (width - 20), rand() % (height - 20));
+			walls.push_back(Wall(Bounds(min, Point(min.x + 20, min.y + 20)), Color24(255, 0, 0)));
+		}
+		objects.AddRange(walls.begin(), walls.end());
+
+		for(long i = 0; i < spawnCount; ++i)
+		{
+			const Point min(rand() % (width - 10), rand() % (height - 10));
+			entities.Create(WorldObject::food, Bounds(min, Point(min.x + 10, min.y + 10)), Color24(0, 255, 0), 0);
+		}
+	}
+};
+
+// an off-screen _width_ x _height_ surface
+static Screen* make_screen(const long width, const long height)
+{
+	return new Screen(SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32, 0, 0, 0, 0), Color24(0, 0, 0));
+}
+
+// draw _arg_ walls and 100 spawns into an off-screen 800x600 surface
+static void bench_graphics_update(Benchmark::State& state)
+{
+	const std::auto_ptr<const Screen> screen(make_screen(800, 600));
+	const Scene scene(800, 600, state.GetArg(), 100);
+	Graphics::Background background;
+	const Graphics::Camera camera(screen->GetBounds());
+
+	while(state.KeepRunning())
+		Graphics::Update(scene.objects, scene.entities, background, camera, *screen);
+}
+BENCHMARK_ARG(bench_graphics_update, 10)
+BENCHMARK_ARG(bench_graphics_update, 100)
+BENCHMARK_ARG(bench_graphics_update, 1000)
+
+// draw 1000 walls and _arg_ spawns into an off-screen 3840x2160 surface, on the calling thread
+static void bench_graphics_update_4k(Benchmark::State& state)
+{
+	const std::auto_ptr<const Screen> screen(make_screen(3840, 2160));
+	const Scene scene(3840, 2160, 1000, state.GetArg());
+	Graphics::Background background;
+	const Graphics::Camera camera(screen->GetBounds());
+
+	while(state.KeepRunning())
+		Graphics::Update(scene.objects, scene.entities, background, camera, *screen);
+}
+BENCHMARK_ARG(bench_graphics_update_4k, 100)
+BENCHMARK_ARG(bench_graphics_update_4k, 10000)
+
+// the same, in tiles, on one thread per core
+static void bench_tiled_renderer_update_4k(Benchmark::State& state)
+{
+	const std::auto_ptr<const Screen> screen(make_screen(3840, 2160));
+	const Scene scene(3840, 2160, 1000, state.GetArg());
+	Graphics::Background background;
+	const Graphics::Camera camera(screen->GetBounds());
+	Graphics::TiledRenderer renderer(boost::thread::hardware_concurrency());
+
+	while(state.KeepRunning())
+		renderer.Update(scene.objects, scene.entities, background, camera, *screen);
+}
+BENCHMARK_ARG(bench_tiled_renderer_update_4k, 100)
+BENCHMARK_ARG(bench_tiled_renderer_update_4k, 10000)
+
+// draw an 800x600 view of an 8000x6000 world with _arg_ walls and 1000 spawns, moving the camera every frame
+static void bench_graphics_update_large_world(Benchmark::State& state)
+{
+	const std::auto_ptr<const Screen> screen(make_screen(800, 600));
+	const Scene scene(8000, 6000, state.GetArg(), 1000);
+	Graphics::Background background;
+	Graphics::Camera camera(screen->GetBounds());
+
+	const Point worldSize(8000, 6000);
+	Point focus(4000, 3000);
+	while(state.KeepRunning())
+	{
+		++focus.x;
+		camera.Follow(Bounds(focus, focus), worldSize);
+		Graphics::Update(scene.objects, scene.entities, background, camera, *screen);
+	}
+}
+BENCHMARK_ARG(bench_graphics_update_large_world, 1000)
+BENCHMARK_ARG(bench_graphics_update_large_world, 100000)
@@ -0,0 +1,91 @@
+#include "benchmark.hpp"
+#include "../main/ChunkCache.hpp"
+#include "../main/Level.hpp"
+#include "../main/OccupancyGrid.hpp"
+#include "../main/ZippedUniqueObjectCollection.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/random.hpp>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+static const long worldWidth = 8000;
+static const long worldHeight = 6000;
+static const long chunkSize = 512;
+
+// _wallCount_ 20x20 walls scattered over the world
+static Level::WallArray make_walls(const long wallCount)
+{
+	boost::minstd_rand rand(42);
+	Level::WallArray walls;
+	for(long i = 0; i < wallCount; ++i)
+	{
+		Level::Compiled::Wall wall = Level::Compiled::Wall();
+		wall.minX = rand() % (worldWidth - 20);
+		wall.minY = rand() % (worldHeight - 20);
+		wall.maxX = wall.minX + 20;
+		wall.maxY = wall.minY + 20;
+		wall.r = 255;
+		walls.push_back(wall);
+	}
+	return walls;
+}
+
+// chop _arg_ walls into chunks
+static void bench_level_build(Benchmark::State& state)
+{
+	const Level::WallArray walls = make_walls(state.GetArg());
+	while(state.KeepRunning())
+		Level level(Point(worldWidth, worldHeight), chunkSize, walls, Level::SpawnArray());
+}
+BENCHMARK_ARG(bench_level_build, 100000)
+
+// stream the chunks around an 800x600 view sweeping across a world of 100000 walls, one pixel per
+// update, keeping at most _arg_ bytes of chunks loaded
+static void bench_chunk_cache_update(Benchmark::State& state)
+{
+	const Level level(Point(worldWidth, worldHeight), chunkSize, make_walls(100000), Level::SpawnArray());
+	ZippedUniqueObjectCollection gameObjects;
+	OccupancyGrid occupancy(worldWidth, worldHeight);
+	ChunkCache chunks;
+	chunks.SetLevel(&level, gameObjects, occupancy);
+	chunks.SetBudget(state.GetArg());
+
+	std::vector<Bounds> cleared;
+	long x = 0;
+	while(state.KeepRunning())
+	{
+		x = (x + 1) % (worldWidth - 800);
+		cleared.clear();
+		chunks.Update(Bounds(Point(x - chunkSize, 2700 - chunkSize), Point(x + 800 + chunkSize, 3300 + chunkSize)),
+			gameObjects, occupancy, cleared);
+	}
+
+	chunks.Clear(gameObjects);
+}
+BENCHMARK_ARG(bench_chunk_cache_update, 1048576)
+BENCHMARK_ARG(bench_chunk_cache_update, 67108864)
+
+// look for walls under random 20x20 spawns, in a world of _arg_ walls
+static void bench_level_any_wall(Benchmark::State& state)
+{
+	const Level level(Point(worldWidth, worldHeight), chunkSize, make_walls(state.GetArg()), Level::SpawnArray());
+
+	boost::minstd_rand rand(5);
+	unsigned long hits = 0;
+	while(state.KeepRunning())
+	{
+		const Point min(rand() % (worldWidth - 20), rand() % (worldHeight - 20));
+		hits += level.AnyWall(Bounds(min, Point(min.x + 20, min.y + 20)));
+	}
+
+	Benchmark::DoNotOptimize(hits);
+}
+BENCHMARK_ARG(bench_level_any_wall, 1000)
+BENCHMARK_ARG(bench_level_any_wall, 100000)
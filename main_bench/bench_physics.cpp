@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+#include "../main/EntityStore.hpp"
+#include "../main/Physics.hpp"
+#include "../main/UniqueObjectCollection.hpp"
+#include "../main/Wall.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/random.hpp>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// _count_ square walls scattered (and sometimes overlapping) over an 800x600 area
+static void make_walls(std::vector<Wall>& walls, const long count)
+{
+	boost::minstd_rand rand(42);
+	for(long i = 0; i < count; ++i)
+	{
+		const Point min(rand() % 790, rand() % 590);
+		walls.push_back(Wall(Bounds(min, Point(min.x + 10, min.y + 10)), Color24(255, 0, 0)));
+	}
+}
+
+static void bench_physics_any_collide(Benchmark::State& state)
+{
+	std::vector<Wall> walls;
+	make_walls(walls, state.GetArg());
+
+	UniqueObjectCollection objects;
+	objects.AddRange(walls.begin(), walls.end());
+
+	const Wall probe(Bounds(Point(-20, -20), Point(-10, -10)), Color24());
+	bool collided = false;
+	while(state.KeepRunning())
+		collided ^= Physics::AnyCollide(probe.GetBounds(), objects);
+
+	Benchmark::DoNotOptimize(collided);
+}
+BENCHMARK_ARG(bench_physics_any_collide, 100)
+BENCHMARK_ARG(bench_physics_any_collide, 1000)
+
+// 10 objects (standing in for the snake) against _arg_ spawns
+static void bench_physics_update_entities(Benchmark::State& state)
+{
+	std::vector<Wall> walls;
+	make_walls(walls, state.GetArg() + 10);
+
+	UniqueObjectCollection objects;
+	objects.AddRange(walls.begin(), walls.begin() + 10);
+
+	EntityStore entities;
+	for(std::vector<Wall>::const_iterator i = walls.begin() + 10, end = walls.end(); i != end; ++i)
+		entities.Create(WorldObject::food, i->GetBounds(), Color24(), 0);
+
+	Physics::EntityCollisionQueue collisions;
+	while(state.KeepRunning())
+	{
+		collisions.clear();
+		Physics::Update(objects, entities, collisions, WorldObject::wall);
+	}
+
+	Benchmark::DoNotOptimize(collisions.size());
+}
+BENCHMARK_ARG(bench_physics_update_entities, 100)
+BENCHMARK_ARG(bench_physics_update_entities, 1000)
@@ -0,0 +1,146 @@
+#include "benchmark.hpp"
+#include "../main/Common.hpp"
+#include "../main/Config.hpp"
+#include "../main/OccupancyGrid.hpp"
+#include "../main/Snake.hpp"
+#include "../main/ZippedUniqueObjectCollection.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// the game's config, loaded on first use
+static const Config& get_config()
+{
+	static const Config config(Config::GetConfigLoader("game.cfg"));
+	return config;
+}
+
+// a food which brings the target length of a fresh snake to about _length_
+static EntityStore::FoodEffects make_growth_food(const unsigned long length)
+{
+	const Config::SnakeConfig& snakeConfig = get_config().snake;
+	const double baseGrowth = std::min(static_cast<double>(snakeConfig.growthCap),
+		snakeConfig.startingLength * snakeConfig.growthRate);
+	const double lengthFactor = (static_cast<double>(length) - snakeConfig.startingLength) / baseGrowth;
+
+	return EntityStore::FoodEffects(0, lengthFactor, 0);
+}
+
+// update the snake _steps_ times, one millisecond apart
+static void step_snake(Snake& snake, Clock& clock, ZippedUniqueObjectCollection& gameObjects, const unsigned long steps)
+{
+	for(unsigned long i = 0; i < steps; ++i)
+	{
+		clock.Advance(1);
+		snake.Update(gameObjects);
+	}
+}
+
+// the turns (and the steps they're taken after) which take a snake heading right round a closed loop: a
+// serpentine of _rows_ rows (an even number), each _rowLength_ long and _pitch_ apart, and a column back
+// up its left side. Returns the length of the loop.
+typedef std::vector<std::pair<unsigned long, Direction> > TurnSchedule;
+static unsigned long make_serpentine(const unsigned long rows, const unsigned long rowLength, const unsigned long pitch,
+	TurnSchedule& turns)
+{
+	unsigned long step = 0;
+	for(unsigned long row = 0; row + 1 < rows; ++row)
+	{
+		const Direction turn = (row % 2 == 0 ? Direction::right : Direction::left);
+		step += rowLength;
+		turns.push_back(std::make_pair(step, turn));
+		step += pitch;
+		turns.push_back(std::make_pair(step, turn));
+	}
+
+	// the last row carries on past the others' ends, to the column back up
+	step += rowLength + pitch;
+	turns.push_back(std::make_pair(step, Direction::right));
+	step += (rows - 1) * pitch;
+	turns.push_back(std::make_pair(step, Direction::right));
+	return step + pitch;
+}
+
+// turn if the schedule says to, and update the snake by a step, _step_ steps into the loop made by _turns_.
+// Returns true iff the snake crashed.
+static inline bool follow_loop(Snake& snake, Clock& clock, ZippedUniqueObjectCollection& gameObjects,
+	const TurnSchedule& turns, const unsigned long loopLength, unsigned long& step,
+	TurnSchedule::const_iterator& nextTurn)
+{
+	if(nextTurn != turns.end() && nextTurn->first == step)
+	{
+		snake.Turn(nextTurn->second, gameObjects);
+		++nextTurn;
+	}
+
+	if(++step == loopLength)
+	{
+		step = 0;
+		nextTurn = turns.begin();
+	}
+
+	clock.Advance(1);
+	return snake.Update(gameObjects);
+}
+
+// Snake::Update for a snake made of about _arg_ segments, going round a loop in a world big enough for it
+static void bench_snake_update(Benchmark::State& state)
+{
+	// one step per millisecond, and no speeding up
+	Config config = get_config();
+	config.snake.startingSpeed = 1000;
+	config.snake.speedupAmount = 0;
+
+	// each row and the step down to the next are two segments, and the loop is three times the snake's length
+	const unsigned long width = config.snake.width;
+	const unsigned long segmentLength = 2 * width;
+	const unsigned long rows = (state.GetArg() + 1) / 2 * 2;
+	TurnSchedule turns;
+	const unsigned long loopLength = make_serpentine(rows, segmentLength, segmentLength, turns);
+
+	// the snake starts in the middle of the world, and goes a few widths and its starting length before the
+	// loop starts
+	config.world.w = 2 * (config.snake.startingLength + segmentLength + 6 * width);
+	config.world.h = 2 * (rows * segmentLength + 4 * width);
+
+	ZippedUniqueObjectCollection gameObjects;
+	Clock clock;
+	Random random(42);
+	OccupancyGrid occupancy(config.world.w, config.world.h);
+	Snake snake(config, clock, random, occupancy, gameObjects);
+
+	// head right, whichever way the snake started out, until it's all out of the loop's way
+	step_snake(snake, clock, gameObjects, width);
+	snake.ChangeDirection(Direction::down, gameObjects);
+	step_snake(snake, clock, gameObjects, width);
+	snake.ChangeDirection(Direction::right, gameObjects);
+	step_snake(snake, clock, gameObjects, config.snake.startingLength + width);
+
+	const unsigned long length = state.GetArg() * segmentLength;
+	snake.EatFood(make_growth_food(length));
+
+	unsigned long step = 0, crashes = 0;
+	TurnSchedule::const_iterator nextTurn = turns.begin();
+
+	// grow to full length
+	for(unsigned long i = 0; i < length; ++i)
+		crashes += follow_loop(snake, clock, gameObjects, turns, loopLength, step, nextTurn);
+
+	while(state.KeepRunning())
+		crashes += follow_loop(snake, clock, gameObjects, turns, loopLength, step, nextTurn);
+
+	Benchmark::DoNotOptimize(crashes);
+}
+BENCHMARK_ARG(bench_snake_update, 10)
+BENCHMARK_ARG(bench_snake_update, 100)
+BENCHMARK_ARG(bench_snake_update, 1000)
+BENCHMARK_ARG(bench_snake_update, 10000)
@@ -0,0 +1,64 @@
+#include "benchmark.hpp"
+#include "../main/Config.hpp"
+#include "../main/GameWorld.hpp"
+#include "../main/ZippedUniqueObjectCollection.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <sstream>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+// a world a minute into a game, with the snake turning every so often
+static GameWorld& get_world()
+{
+	static const GameWorld::ConfigPtr config(new Config(Config::GetConfigLoader("game.cfg")));
+	static ZippedUniqueObjectCollection gameObjects;
+	static GameWorld* world = NULL;
+
+	if(world == NULL)
+	{
+		world = new GameWorld(config, gameObjects, 42);
+
+		for(unsigned long tick = 0; tick < 60 * 1000 / GameWorld::tickLength; ++tick)
+		{
+			if(tick % 100 == 0)
+				world->MouseNotify((tick / 100) % 3 ? SDL_BUTTON_LEFT : SDL_BUTTON_RIGHT);
+
+			world->Step();
+		}
+	}
+
+	return *world;
+}
+
+static void bench_snapshot_save(Benchmark::State& state)
+{
+	GameWorld& world = get_world();
+	std::stringstream snapshot;
+
+	while(state.KeepRunning())
+	{
+		snapshot.seekp(0);
+		world.SaveSnapshot(snapshot);
+	}
+}
+BENCHMARK(bench_snapshot_save)
+
+static void bench_snapshot_load(Benchmark::State& state)
+{
+	GameWorld& world = get_world();
+	std::stringstream snapshot;
+	world.SaveSnapshot(snapshot);
+
+	while(state.KeepRunning())
+	{
+		snapshot.seekg(0);
+		world.LoadSnapshot(snapshot);
+	}
+}
+BENCHMARK(bench_snapshot_load)
@@ -0,0 +1,207 @@
+#include "benchmark.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+namespace Benchmark
+{
+	// how long each benchmark should run for, at least, in seconds
+	static const double minTime = 0.25;
+	static const unsigned long maxIterations = 1000000000;
+
+	struct Entry
+	{
+		std::string name;
+		Function* function;
+		long arg;
+	};
+
+	typedef std::vector<Entry> Registry;
+
+	static Registry& get_registry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	static void add_entry(const std::string& name, Function* const function, const long arg)
+	{
+		Entry entry;
+		entry.name = name;
+		entry.function = function;
+		entry.arg = arg;
+
+		get_registry().push_back(entry);
+	}
+
+	static inline double get_wall_microseconds()
+	{
+		static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+	}
+
+	Registration::Registration(const char* const name, Function* const function)
+	{
+		add_entry(name, function, 0);
+	}
+
+	Registration::Registration(const char* const name, Function* const function, const long arg)
+	{
+		char fullName[256];
+		sprintf(fullName, "%.200s/%ld", name, arg);
+
+		add_entry(fullName, function, arg);
+	}
+
+	static const void* volatile sink;
+
+	void DoNotOptimizeAway(const void* const p)
+	{
+		sink = p;
+	}
+
+	State::State(const long _arg, const unsigned long _iterations)
+	{
+		arg = _arg;
+		iterations = remaining = _iterations;
+		running = false;
+		wallStart = wallElapsed = 0;
+		cpuStart = cpuElapsed = 0;
+	}
+
+	bool State::KeepRunning()
+	{
+		if(!running && remaining == iterations)
+			ResumeTiming();
+
+		if(remaining == 0)
+		{
+			PauseTiming();
+			return false;
+		}
+
+		--remaining;
+		return true;
+	}
+
+	void State::PauseTiming()
+	{
+		if(!running)
+			return;
+
+		wallElapsed += get_wall_microseconds() - wallStart;
+		cpuElapsed += clock() - cpuStart;
+		running = false;
+	}
+
+	void State::ResumeTiming()
+	{
+		running = true;
+		wallStart = get_wall_microseconds();
+		cpuStart = clock();
+	}
+
+	long State::GetArg() const
+	{
+		return arg;
+	}
+
+	unsigned long State::GetIterations() const
+	{
+		return iterations;
+	}
+
+	double State::GetWallTime() const
+	{
+		return wallElapsed / 1e6;
+	}
+
+	double State::GetCPUTime() const
+	{
+		return cpuElapsed / CLOCKS_PER_SEC;
+	}
+
+	// run _entry_ with increasing iteration counts, until it takes long enough to measure
+	static State run(const Entry& entry)
+	{
+		for(unsigned long iterations = 1; ; iterations *= 10)
+		{
+			State state(entry.arg, iterations);
+			entry.function(state);
+
+			if(state.GetWallTime() >= minTime || iterations >= maxIterations)
+				return state;
+
+			// jump straight to roughly the right count, if possible
+			if(state.GetWallTime() > minTime / 100)
+			{
+				State finalState(entry.arg, static_cast<unsigned long>(iterations * minTime / state.GetWallTime() * 1.2));
+				entry.function(finalState);
+				return finalState;
+			}
+		}
+	}
+}
+
+// usage: snake_bench [--out results.json] [filter]
+// runs every benchmark whose name contains _filter_. The results are written to _results.json_ (or stdout), as
+// JSON; since the log goes to stdout, debug builds need --out for the JSON to be readable on its own.
+int main(int argc, char* argv[])
+{
+	const char* filter = "";
+	const char* outFilename = NULL;
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			outFilename = argv[++i];
+		else
+			filter = argv[i];
+	}
+
+	FILE* const out = (outFilename != NULL) ? fopen(outFilename, "w") : stdout;
+	if(out == NULL)
+	{
+		fprintf(stderr, "Unable to open \"%s\"\n", outFilename);
+		return 1;
+	}
+
+	const Benchmark::Registry& registry = Benchmark::get_registry();
+
+	fprintf(out, "{\n  \"context\": {\n    \"executable\": \"%s\",\n    \"time_unit\": \"ns\"\n  },\n  \"benchmarks\": [", argv[0]);
+
+	const char* separator = "\n";
+	for(Benchmark::Registry::const_iterator i = registry.begin(), end = registry.end(); i != end; ++i)
+	{
+		if(strstr(i->name.c_str(), filter) == NULL)
+			continue;
+
+		const Benchmark::State result = Benchmark::run(*i);
+		const double realTime = result.GetWallTime() * 1e9 / result.GetIterations();
+		const double cpuTime = result.GetCPUTime() * 1e9 / result.GetIterations();
+
+		fprintf(out, "%s    {\"name\": \"%s\", \"iterations\": %lu, \"real_time\": %.2f, \"cpu_time\": %.2f, \"time_unit\": \"ns\"}",
+			separator, i->name.c_str(), result.GetIterations(), realTime, cpuTime);
+		fprintf(stderr, "%-40s %12.2f ns %12lu iterations\n", i->name.c_str(), realTime, result.GetIterations());
+
+		separator = ",\n";
+	}
+
+	fprintf(out, "\n  ]\n}\n");
+
+	if(out != stdout)
+		fclose(out);
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+// A minimal harness in the style of Google Benchmark. A benchmark is a function which
+// runs its code under test in a `while(state.KeepRunning())` loop; anything before the
+// loop is setup, and isn't timed. Results are written to stdout as JSON.
+
+namespace Benchmark
+{
+	class State
+	{
+	private:
+		long arg;
+		unsigned long iterations;
+		unsigned long remaining;
+		bool running;
+
+		// microseconds of wall time, and clock ticks of CPU time
+		double wallStart, wallElapsed;
+		double cpuStart, cpuElapsed;
+
+	public:
+		State(long arg, unsigned long iterations);
+
+		// returns true while there are iterations left to run. The timer starts on the first call.
+		bool KeepRunning();
+
+		// stop timing, for per-iteration setup that shouldn't be measured
+		void PauseTiming();
+		void ResumeTiming();
+
+		// the argument the benchmark was registered with
+		long GetArg() const;
+		unsigned long GetIterations() const;
+		// total time spent in the timed loop, in seconds
+		double GetWallTime() const;
+		double GetCPUTime() const;
+	};
+
+	typedef void (Function)(State&);
+
+	// adds a benchmark to the suite
+	struct Registration
+	{
+		Registration(const char* name, Function* function);
+		Registration(const char* name, Function* function, long arg);
+	};
+
+	void DoNotOptimizeAway(const void*);
+
+	// keep _value_ from being optimized away, along with the computation that produced it
+	template <typename _T>
+	inline void DoNotOptimize(const _T& value)
+	{
+		DoNotOptimizeAway(&value);
+	}
+}
+
+#define BENCHMARK(function) \
+	static const Benchmark::Registration benchmark_##function(#function, &function);
+
+#define BENCHMARK_ARG(function, arg) \
+	static const Benchmark::Registration benchmark_##function##_##arg(#function, &function, arg);
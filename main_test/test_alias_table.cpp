@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "../main/AliasTable.hpp"
+#include "../main/Common.hpp"
+#include "../main/Config.hpp"
+
+#include <string>
+#include <vector>
+
+static const unsigned long sampleCount = 200000;
+
+// how often each of _table_'s outcomes comes up, out of _sampleCount_ picks
+static std::vector<double> get_frequencies(const AliasTable& table)
+{
+	Random random(11);
+	std::vector<double> frequencies(table.GetSize(), 0);
+	for(unsigned long i = 0; i < sampleCount; ++i)
+	{
+		const unsigned long outcome = table.Sample(random);
+		EXPECT_LT(outcome, table.GetSize());
+		if(outcome < table.GetSize())
+			frequencies[outcome] += 1.0 / sampleCount;
+	}
+
+	return frequencies;
+}
+
+// _frequencies_ are close to _expected_, and exactly 0 wherever that's expected
+static void expect_frequencies(const double* const expected, const std::vector<double>& frequencies)
+{
+	for(unsigned long i = 0; i < frequencies.size(); ++i)
+	{
+		if(expected[i] == 0)
+			EXPECT_EQ(0, frequencies[i]) << "outcome " << i;
+		else
+			EXPECT_NEAR(expected[i], frequencies[i], 0.01) << "outcome " << i;
+	}
+}
+
+TEST(alias_table, single_outcome)
+{
+	const AliasTable table(std::vector<double>(1, 3));
+	ASSERT_EQ(1u, table.GetSize());
+
+	const double expected[] = {1};
+	expect_frequencies(expected, get_frequencies(table));
+}
+
+TEST(alias_table, matches_weights)
+{
+	const double weights[] = {1, 2, 3, 0, 4};
+	const AliasTable table(std::vector<double>(weights, weights + countof(weights)));
+	ASSERT_EQ(countof(weights), table.GetSize());
+
+	const double expected[] = {0.1, 0.2, 0.3, 0, 0.4};
+	expect_frequencies(expected, get_frequencies(table));
+}
+
+TEST(alias_table, negative_weights_count_as_zero)
+{
+	const double weights[] = {-5, 1, -1, 1};
+	const AliasTable table(std::vector<double>(weights, weights + countof(weights)));
+
+	const double expected[] = {0, 0.5, 0, 0.5};
+	expect_frequencies(expected, get_frequencies(table));
+}
+
+TEST(alias_table, all_zero_weights_are_equally_likely)
+{
+	const AliasTable table(std::vector<double>(4, 0));
+
+	const double expected[] = {0.25, 0.25, 0.25, 0.25};
+	expect_frequencies(expected, get_frequencies(table));
+}
+
+// the spawn table from a config with a food and a mine spawning at _foodRate_ and _mineRate_
+static AliasTable get_spawn_table(const std::string& foodRate, const std::string& mineRate)
+{
+	const Config::ConfigScope root(
+		"{ spawns\n"
+		"	period 1000\n"
+		"	{ bounds { min x 0 y 0 } { max x 100 y 100 } }\n"
+		"	{ foods { food size 10 cushion 0 expiry 1000 rate " + foodRate + " { color r 0 g 255 b 0 } } }\n"
+		"	{ mines { mine size 10 cushion 0 expiry 1000 rate " + mineRate + " { color r 255 g 0 b 0 } } }\n"
+		"}\n");
+	const Config::SpawnCollectionConfig spawns(&root);
+
+	EXPECT_EQ(2u, spawns.spawnsConfig.size());
+	return spawns.spawnTable;
+}
+
+// whatever the spawn rates leave over goes to the last outcome, which spawns nothing
+TEST(alias_table, no_spawn_remainder)
+{
+	const double expected[] = {0.2, 0.3, 0.5};
+	expect_frequencies(expected, get_frequencies(get_spawn_table("0.2", "0.3")));
+}
+
+TEST(alias_table, spawn_rates_adding_up_to_one)
+{
+	const double expected[] = {0.7, 0.3, 0};
+	expect_frequencies(expected, get_frequencies(get_spawn_table("0.7", "0.3")));
+}
+
+// rates adding up to more than 1 are scaled down, leaving nothing for the no-spawn outcome
+TEST(alias_table, spawn_rates_over_one)
+{
+	const double expected[] = {0.75, 0.25, 0};
+	expect_frequencies(expected, get_frequencies(get_spawn_table("1.5", "0.5")));
+}
@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include "../main/Common.hpp"
+#include "../main/Config.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef Config::ConfigScope::Token Token;
+typedef Config::ConfigScope::Tokenizer Tokenizer;
+
+// all of the tokens in _text_
+static std::vector<Token> tokenize(const char* const text)
+{
+	Tokenizer tokenizer(text, text + strlen(text));
+
+	std::vector<Token> tokens;
+	Token token;
+	while(tokenizer.Next(token))
+		tokens.push_back(token);
+
+	return tokens;
+}
+
+TEST(config, tokenizer_splits_on_whitespace)
+{
+	const char* const text = "  { screen\tw 800\r\n\th 600 }\n";
+	const std::vector<Token> tokens = tokenize(text);
+
+	const char* const expected[] = {"{", "screen", "w", "800", "h", "600", "}"};
+	ASSERT_EQ(countof(expected), tokens.size());
+	for(unsigned long i = 0; i < tokens.size(); ++i)
+		EXPECT_EQ(expected[i], tokens[i].GetString());
+}
+
+// tokens are views into the text, not copies of it
+TEST(config, tokenizer_does_not_copy)
+{
+	const char* const text = "abc  de\nf";
+	const std::vector<Token> tokens = tokenize(text);
+
+	ASSERT_EQ(3u, tokens.size());
+	EXPECT_EQ(text, tokens[0].begin);
+	EXPECT_EQ(3u, tokens[0].length);
+	EXPECT_EQ(text + 5, tokens[1].begin);
+	EXPECT_EQ(2u, tokens[1].length);
+	EXPECT_EQ(text + 8, tokens[2].begin);
+	EXPECT_EQ(1u, tokens[2].length);
+}
+
+TEST(config, tokenizer_empty_text)
+{
+	EXPECT_TRUE(tokenize("").empty());
+	EXPECT_TRUE(tokenize(" \t\r\n ").empty());
+}
+
+TEST(config, token_comparison)
+{
+	const char* const text = "screen";
+	const Token token(text, 6);
+	const Token prefix(text, 3);
+
+	EXPECT_TRUE(token == "screen");
+	EXPECT_FALSE(token == "scree");
+	EXPECT_FALSE(token == "screens");
+	EXPECT_TRUE(token == std::string("screen"));
+	EXPECT_FALSE(prefix == std::string("screen"));
+	EXPECT_TRUE(prefix == "scr");
+	EXPECT_TRUE(token == Token("screen", 6));
+	EXPECT_FALSE(token == prefix);
+}
+
+// _text_ as a whole token
+static Token make_token(const char* const text)
+{
+	return Token(text, strlen(text));
+}
+
+TEST(config, token_to_unsigned)
+{
+	unsigned long long value = 7;
+	EXPECT_TRUE(make_token("0").ToUnsigned(value));
+	EXPECT_EQ(0u, value);
+	EXPECT_TRUE(make_token("+42").ToUnsigned(value));
+	EXPECT_EQ(42u, value);
+	EXPECT_TRUE(make_token("18446744073709551615").ToUnsigned(value));
+	EXPECT_EQ(~0ULL, value);
+
+	value = 7;
+	EXPECT_FALSE(make_token("18446744073709551616").ToUnsigned(value));
+	EXPECT_FALSE(make_token("-1").ToUnsigned(value));
+	EXPECT_FALSE(make_token("+").ToUnsigned(value));
+	EXPECT_FALSE(make_token("").ToUnsigned(value));
+	EXPECT_FALSE(make_token("12a").ToUnsigned(value));
+	EXPECT_FALSE(make_token("1.5").ToUnsigned(value));
+	EXPECT_EQ(7u, value);
+}
+
+TEST(config, token_to_integer)
+{
+	long long value = 7;
+	EXPECT_TRUE(make_token("-42").ToInteger(value));
+	EXPECT_EQ(-42, value);
+	EXPECT_TRUE(make_token("9223372036854775807").ToInteger(value));
+	EXPECT_EQ(9223372036854775807LL, value);
+	EXPECT_TRUE(make_token("-9223372036854775808").ToInteger(value));
+	EXPECT_EQ(-9223372036854775807LL - 1, value);
+
+	value = 7;
+	EXPECT_FALSE(make_token("9223372036854775808").ToInteger(value));
+	EXPECT_FALSE(make_token("-9223372036854775809").ToInteger(value));
+	EXPECT_FALSE(make_token("-").ToInteger(value));
+	EXPECT_FALSE(make_token("--1").ToInteger(value));
+	EXPECT_FALSE(make_token("0x10").ToInteger(value));
+	EXPECT_EQ(7, value);
+}
+
+TEST(config, token_to_double)
+{
+	double value = 7;
+	EXPECT_TRUE(make_token("0.345").ToDouble(value));
+	EXPECT_DOUBLE_EQ(0.345, value);
+	EXPECT_TRUE(make_token("-2.5").ToDouble(value));
+	EXPECT_DOUBLE_EQ(-2.5, value);
+	EXPECT_TRUE(make_token("15").ToDouble(value));
+	EXPECT_DOUBLE_EQ(15, value);
+
+	value = 7;
+	EXPECT_FALSE(make_token("").ToDouble(value));
+	EXPECT_FALSE(make_token("1.5x").ToDouble(value));
+	EXPECT_FALSE(make_token("1e400").ToDouble(value));
+	EXPECT_DOUBLE_EQ(7, value);
+}
+
+static const char* const sampleConfig =
+	"music 1 sound 0\n"
+	"FPS 60\n"
+	"{ screen w 800 h 600 }\n"
+	"{ walls\n"
+	"	{ wall { bounds { min x 1 y 2 } { max x 3 y 4 } } }\n"
+	"	{ wall { bounds { min x 5 y 6 } { max x 7 y 8 } } }\n"
+	"}\n"
+	"{ snake growthRate 0.345 name sam }\n"
+	"pointGainAmount -15\n";
+
+// the fields of _sampleConfig_ can all be found in _root_
+static void expect_sample_config(const Config::ConfigScope& root)
+{
+	bool music = false, sound = true;
+	unsigned short fps = 0;
+	long long pointGainAmount = 0;
+	root.GetField("music", music);
+	root.GetField("sound", sound);
+	root.GetField("FPS", fps);
+	root.GetField("pointGainAmount", pointGainAmount);
+	EXPECT_TRUE(music);
+	EXPECT_FALSE(sound);
+	EXPECT_EQ(60, fps);
+	EXPECT_EQ(-15, pointGainAmount);
+
+	const Config::ConfigScope* const screen = root.GetScope("screen");
+	ASSERT_TRUE(screen != NULL);
+	unsigned long w = 0, h = 0;
+	screen->GetField("w", w);
+	screen->GetField("h", h);
+	EXPECT_EQ(800u, w);
+	EXPECT_EQ(600u, h);
+
+	const Config::ConfigScope* const walls = root.GetScope("walls");
+	ASSERT_TRUE(walls != NULL);
+	ASSERT_EQ(2u, walls->CountScopes("wall"));
+	for(unsigned long i = 0; i < 2; ++i)
+	{
+		const Config::ConfigScope* const bounds = walls->GetScope("wall", i)->GetScope("bounds");
+		ASSERT_TRUE(bounds != NULL);
+
+		long minX = 0, maxY = 0;
+		bounds->GetScope("min")->GetField("x", minX);
+		bounds->GetScope("max")->GetField("y", maxY);
+		EXPECT_EQ(static_cast<long>(1 + 4 * i), minX);
+		EXPECT_EQ(static_cast<long>(4 + 4 * i), maxY);
+	}
+	EXPECT_TRUE(walls->GetScope("wall", 2) == NULL);
+
+	const Config::ConfigScope* const snake = root.GetScope("snake");
+	ASSERT_TRUE(snake != NULL);
+	double growthRate = 0;
+	std::string name;
+	snake->GetField("growthRate", growthRate);
+	snake->GetField("name", name);
+	EXPECT_DOUBLE_EQ(0.345, growthRate);
+	EXPECT_EQ("sam", name);
+
+	EXPECT_TRUE(root.GetScope("world") == NULL);
+	EXPECT_EQ(0u, root.CountScopes("world"));
+}
+
+TEST(config, parse_text)
+{
+	expect_sample_config(Config::ConfigScope(std::string(sampleConfig)));
+}
+
+// configs which end right after a '{', right after a scope's name, and partway through a field
+static const char* const truncatedConfigs[] = {
+	"music 1\n{ screen w 5 }\n{",
+	"music 1\n{ screen w 5 }\n{ walls",
+	"music 1\n{ screen w 5 }\nsound",
+	"music 1\n{ screen w",
+};
+
+// everything before the end of a truncated config is kept
+static void expect_truncated_config(const Config::ConfigScope& root, const unsigned long index)
+{
+	int music = 0;
+	root.GetField("music", music);
+	EXPECT_EQ(1, music) << "config " << index;
+
+	const Config::ConfigScope* const screen = root.GetScope("screen");
+	ASSERT_TRUE(screen != NULL) << "config " << index;
+
+	unsigned long w = 0;
+	screen->GetField("w", w);
+	EXPECT_EQ(index < 3 ? 5u : 0u, w) << "config " << index;
+}
+
+TEST(config, parse_truncated_text)
+{
+	for(unsigned long i = 0; i < countof(truncatedConfigs); ++i)
+		expect_truncated_config(Config::ConfigScope(std::string(truncatedConfigs[i])), i);
+}
+
+static const char* const compiledFilename = "test_config.cfgc";
+
+// write _root_ in compiled form, then map it back in
+static std::auto_ptr<Config::ConfigScope> round_trip(const Config::ConfigScope& root)
+{
+	{
+		std::ofstream out(compiledFilename, std::ios::binary);
+		root.WriteCompiled(out);
+	}
+
+	return Config::ConfigScope::LoadCompiled(compiledFilename);
+}
+
+TEST(config, compiled_round_trip)
+{
+	{
+		const std::auto_ptr<Config::ConfigScope> compiled = round_trip(Config::ConfigScope(std::string(sampleConfig)));
+		ASSERT_TRUE(compiled.get() != NULL);
+		expect_sample_config(*compiled);
+	}
+
+	for(unsigned long i = 0; i < countof(truncatedConfigs); ++i)
+	{
+		const std::auto_ptr<Config::ConfigScope> compiled =
+			round_trip(Config::ConfigScope(std::string(truncatedConfigs[i])));
+		ASSERT_TRUE(compiled.get() != NULL) << "config " << i;
+		expect_truncated_config(*compiled, i);
+	}
+
+	std::remove(compiledFilename);
+}
+
+// anything that isn't a whole compiled config is rejected
+TEST(config, load_compiled_rejects_other_files)
+{
+	std::string compiled;
+	{
+		std::ostringstream out;
+		Config::ConfigScope(std::string(sampleConfig)).WriteCompiled(out);
+		compiled = out.str();
+	}
+
+	const std::string badFiles[] = {
+		std::string(sampleConfig),
+		compiled.substr(0, compiled.size() / 2),
+		compiled.substr(0, 8),
+		std::string(),
+	};
+	for(unsigned long i = 0; i < countof(badFiles); ++i)
+	{
+		{
+			std::ofstream out(compiledFilename, std::ios::binary);
+			out << badFiles[i];
+		}
+
+		EXPECT_TRUE(Config::ConfigScope::LoadCompiled(compiledFilename).get() == NULL) << "file " << i;
+	}
+
+	std::remove(compiledFilename);
+	EXPECT_TRUE(Config::ConfigScope::LoadCompiled(compiledFilename).get() == NULL);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "../main/Bounds.hpp"
+#include "../main/Common.hpp"
+#include "../main/Direction.hpp"
+
+static const Direction::Value directions[] = {Direction::left, Direction::right, Direction::up, Direction::down};
+
+// a line starting at (_x_, _y_), _length_ long
+static Line make_line(const long x, const long y, const unsigned short length, const bool horizontal)
+{
+	Line line;
+	line.min = Point(x, y);
+	line.length = length;
+	line.horizontal = horizontal;
+	return line;
+}
+
+static void expect_line(const Line& expected, const Line& actual)
+{
+	EXPECT_EQ(expected.min.x, actual.min.x);
+	EXPECT_EQ(expected.min.y, actual.min.y);
+	EXPECT_EQ(expected.length, actual.length);
+	EXPECT_EQ(expected.horizontal, actual.horizontal);
+}
+
+static void expect_bounds(const Bounds& expected, const Bounds& actual)
+{
+	EXPECT_EQ(expected.min.x, actual.min.x);
+	EXPECT_EQ(expected.min.y, actual.min.y);
+	EXPECT_EQ(expected.max.x, actual.max.x);
+	EXPECT_EQ(expected.max.y, actual.max.y);
+}
+
+TEST(direction, vectors)
+{
+	EXPECT_TRUE(Vector2D(-1, 0) == Vector2D(Direction(Direction::left)));
+	EXPECT_TRUE(Vector2D(1, 0) == Vector2D(Direction(Direction::right)));
+	EXPECT_TRUE(Vector2D(0, -1) == Vector2D(Direction(Direction::up)));
+	EXPECT_TRUE(Vector2D(0, 1) == Vector2D(Direction(Direction::down)));
+	EXPECT_TRUE(Vector2D(0, 0) == Vector2D(Direction(Direction::empty)));
+	EXPECT_TRUE(Vector2D(0, 0) == Vector2D(Direction()));
+}
+
+TEST(direction, negation)
+{
+	EXPECT_EQ(Direction::right, (-Direction(Direction::left)).GetValue());
+	EXPECT_EQ(Direction::left, (-Direction(Direction::right)).GetValue());
+	EXPECT_EQ(Direction::down, (-Direction(Direction::up)).GetValue());
+	EXPECT_EQ(Direction::up, (-Direction(Direction::down)).GetValue());
+	EXPECT_EQ(Direction::empty, (-Direction(Direction::empty)).GetValue());
+
+	for(unsigned long i = 0; i < countof(directions); ++i)
+		EXPECT_TRUE(-Vector2D(Direction(directions[i])) == Vector2D(-Direction(directions[i])));
+}
+
+TEST(direction, orientation)
+{
+	EXPECT_TRUE(Direction(Direction::left).IsHorizontal());
+	EXPECT_TRUE(Direction(Direction::right).IsHorizontal());
+	EXPECT_FALSE(Direction(Direction::up).IsHorizontal());
+	EXPECT_FALSE(Direction(Direction::down).IsHorizontal());
+}
+
+TEST(direction, get_side)
+{
+	const Bounds bounds(Point(10, 20), Point(14, 27));
+
+	expect_line(make_line(10, 20, 7, false), bounds.GetSide(Direction::left));
+	expect_line(make_line(14, 20, 7, false), bounds.GetSide(Direction::right));
+	expect_line(make_line(10, 20, 4, true), bounds.GetSide(Direction::up));
+	expect_line(make_line(10, 27, 4, true), bounds.GetSide(Direction::down));
+}
+
+TEST(direction, set_side)
+{
+	const Bounds original(Point(10, 20), Point(14, 27));
+
+	Bounds bounds = original;
+	bounds.SetSide(make_line(5, 18, 12, false), Direction::left);
+	expect_bounds(Bounds(Point(5, 18), Point(14, 30)), bounds);
+
+	bounds = original;
+	bounds.SetSide(make_line(16, 18, 12, false), Direction::right);
+	expect_bounds(Bounds(Point(10, 18), Point(16, 30)), bounds);
+
+	bounds = original;
+	bounds.SetSide(make_line(8, 15, 9, true), Direction::up);
+	expect_bounds(Bounds(Point(8, 15), Point(17, 27)), bounds);
+
+	bounds = original;
+	bounds.SetSide(make_line(8, 31, 9, true), Direction::down);
+	expect_bounds(Bounds(Point(8, 20), Point(17, 31)), bounds);
+}
+
+// setting a side to what it already is changes nothing
+TEST(direction, side_round_trip)
+{
+	const Bounds original(Point(-3, 8), Point(12, 9));
+
+	for(unsigned long i = 0; i < countof(directions); ++i)
+	{
+		Bounds bounds = original;
+		bounds.SetSide(original.GetSide(directions[i]), directions[i]);
+		expect_bounds(original, bounds);
+	}
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "../main/OccupancyGrid.hpp"
+
+#include <algorithm>
+#include <boost/random.hpp>
+#include <vector>
+
+// a one-pixel bounds at _x_, _y_
+static Bounds pixel(const long x, const long y)
+{
+	return Bounds(Point(x, y), Point(x + 1, y + 1));
+}
+
+TEST(occupancy_grid, starts_empty)
+{
+	const OccupancyGrid grid(200, 100);
+
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 0), Point(200, 100))));
+}
+
+TEST(occupancy_grid, word_boundaries)
+{
+	OccupancyGrid grid(300, 300);
+	grid.Set(pixel(63, 5));
+	grid.Set(pixel(128, 64));
+
+	// horizontal runs are tested along the rows, and vertical ones down the columns
+	EXPECT_TRUE(grid.Any(Bounds(Point(0, 5), Point(64, 6))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 5), Point(63, 6))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(64, 5), Point(300, 6))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(63, 0), Point(64, 300))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(62, 0), Point(63, 300))));
+
+	EXPECT_TRUE(grid.Any(Bounds(Point(127, 64), Point(129, 65))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 64), Point(128, 65))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(129, 64), Point(300, 65))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(128, 0), Point(129, 65))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(128, 0), Point(129, 64))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(128, 65), Point(129, 300))));
+}
+
+// runs which start and end partway through words, with whole words between them
+TEST(occupancy_grid, spans_across_words)
+{
+	OccupancyGrid grid(300, 300);
+	grid.Set(Bounds(Point(60, 10), Point(200, 11)));
+	grid.Set(Bounds(Point(20, 70), Point(21, 250)));
+
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 10), Point(60, 11))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(0, 10), Point(61, 11))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(199, 10), Point(300, 11))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(200, 10), Point(300, 11))));
+
+	EXPECT_FALSE(grid.Any(Bounds(Point(20, 0), Point(21, 70))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(20, 0), Point(21, 71))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(20, 249), Point(21, 300))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(20, 250), Point(21, 300))));
+
+	grid.Unset(Bounds(Point(100, 0), Point(150, 300)));
+	EXPECT_FALSE(grid.Any(Bounds(Point(100, 10), Point(150, 11))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(99, 10), Point(100, 11))));
+	EXPECT_TRUE(grid.Any(Bounds(Point(150, 10), Point(151, 11))));
+}
+
+TEST(occupancy_grid, off_the_grid_is_occupied)
+{
+	const OccupancyGrid grid(100, 80);
+
+	EXPECT_TRUE(grid.Any(pixel(-1, 0)));
+	EXPECT_TRUE(grid.Any(pixel(0, -1)));
+	EXPECT_TRUE(grid.Any(pixel(100, 0)));
+	EXPECT_TRUE(grid.Any(pixel(0, 80)));
+	EXPECT_TRUE(grid.Any(Bounds(Point(90, 10), Point(101, 11))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 0), Point(100, 80))));
+
+	// empty bounds have no pixels to be occupied, wherever they are
+	EXPECT_FALSE(grid.Any(Bounds(Point(-5, -5), Point(-5, 10))));
+	EXPECT_FALSE(grid.Any(Bounds(Point(10, 10), Point(5, 20))));
+}
+
+// only the part of the bounds on the grid is set
+TEST(occupancy_grid, edges_are_clamped)
+{
+	OccupancyGrid grid(100, 80);
+	grid.Set(Bounds(Point(-20, -20), Point(10, 5)));
+	grid.Set(Bounds(Point(95, 70), Point(200, 200)));
+	grid.Set(Bounds(Point(-50, -50), Point(-10, -10)));
+
+	EXPECT_TRUE(grid.Any(pixel(0, 0)));
+	EXPECT_TRUE(grid.Any(pixel(9, 4)));
+	EXPECT_FALSE(grid.Any(pixel(10, 4)));
+	EXPECT_FALSE(grid.Any(pixel(9, 5)));
+	EXPECT_TRUE(grid.Any(pixel(99, 79)));
+	EXPECT_TRUE(grid.Any(pixel(95, 70)));
+	EXPECT_FALSE(grid.Any(pixel(94, 70)));
+	EXPECT_FALSE(grid.Any(pixel(95, 69)));
+
+	grid.Unset(Bounds(Point(-100, -100), Point(200, 200)));
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 0), Point(100, 80))));
+}
+
+TEST(occupancy_grid, clear_and_resize)
+{
+	OccupancyGrid grid(100, 80);
+	grid.Set(Bounds(Point(10, 10), Point(50, 50)));
+	grid.Clear();
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 0), Point(100, 80))));
+
+	grid.Set(Bounds(Point(10, 10), Point(50, 50)));
+	grid.Resize(150, 130);
+	EXPECT_FALSE(grid.Any(Bounds(Point(0, 0), Point(150, 130))));
+	EXPECT_TRUE(grid.Any(pixel(150, 0)));
+}
+
+// random sets, unsets and tests, against a pixel-by-pixel copy
+TEST(occupancy_grid, matches_naive_grid)
+{
+	const long width = 150, height = 130;
+	OccupancyGrid grid(width, height);
+	std::vector<bool> pixels(width * height, false);
+
+	boost::minstd_rand rand(3);
+	for(unsigned long i = 0; i < 5000; ++i)
+	{
+		const Point min(static_cast<long>(rand() % (width + 40)) - 20, static_cast<long>(rand() % (height + 40)) - 20);
+		const Point max(min.x + rand() % 90, min.y + rand() % 90);
+		const Bounds bounds(min, max);
+
+		switch(rand() % 3)
+		{
+			case 0:
+			case 1:
+			{
+				const bool set = (rand() % 3 != 0);
+				if(set)
+					grid.Set(bounds);
+				else
+					grid.Unset(bounds);
+
+				for(long y = std::max<long>(min.y, 0); y < std::min<long>(max.y, height); ++y)
+					for(long x = std::max<long>(min.x, 0); x < std::min<long>(max.x, width); ++x)
+						pixels[y * width + x] = set;
+				break;
+			}
+			default:
+			{
+				bool expected = false;
+				if(min.x < max.x && min.y < max.y)
+				{
+					expected = (min.x < 0 || min.y < 0 || max.x > width || max.y > height);
+					for(long y = min.y; y < max.y && !expected; ++y)
+						for(long x = min.x; x < max.x && !expected; ++x)
+							expected = pixels[y * width + x];
+				}
+
+				EXPECT_EQ(expected, grid.Any(bounds)) << "test " << i;
+			}
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "../main/Camera.hpp"
+#include "../main/EntityStore.hpp"
+#include "../main/Graphics.hpp"
+#include "../main/Screen.hpp"
+#include "../main/SnakeSegment.hpp"
+#include "../main/TiledRenderer.hpp"
+#include "../main/UniqueObjectCollection.hpp"
+#include "../main/Wall.hpp"
+
+#include <boost/random.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// everything in a randomly generated world, kept alive for as long as the game objects point into it
+struct Scene
+{
+	std::vector<Wall> walls;
+	std::vector<SnakeSegment> segments;
+	UniqueObjectCollection graphicsObjects;
+	EntityStore entities;
+
+	// _count_ walls, snake segments and entities (picked at random) in and around a _worldSize_ world
+	Scene(boost::minstd_rand& rand, const Point worldSize, const unsigned long count)
+	{
+		walls.reserve(count);
+		segments.reserve(count);
+
+		for(unsigned long i = 0; i < count; ++i)
+		{
+			const Point min(static_cast<long>(rand() % (worldSize.x + 100)) - 50,
+				static_cast<long>(rand() % (worldSize.y + 100)) - 50);
+			const Point max(min.x + rand() % 80, min.y + rand() % 80);
+			const Color24 color(rand() % 8 * 30, rand() % 8 * 30, rand() % 4 * 60);
+
+			switch(rand() % 3)
+			{
+				case 0:
+					walls.push_back(Wall(Bounds(min, max), color));
+					graphicsObjects.Add(walls.back());
+					break;
+				case 1:
+					segments.push_back(SnakeSegment(min, Direction::right, rand() % 80, rand() % 20 + 1, color));
+					graphicsObjects.Add(segments.back());
+					break;
+				default:
+					entities.Create(WorldObject::food, Bounds(min, max), color, 0);
+			}
+		}
+	}
+};
+
+// a fresh off-screen Screen
+static Screen* make_screen(const Point size)
+{
+	return new Screen(SDL_CreateRGBSurface(SDL_SWSURFACE, size.x, size.y, 32, 0, 0, 0, 0), Color24(1, 2, 3));
+}
+
+// true iff _a_ and _b_ (the same size) have exactly the same pixels
+static bool same_pixels(const Screen& a, const Screen& b)
+{
+	SDL_Surface* const surfaceA = a.GetSurface();
+	SDL_Surface* const surfaceB = b.GetSurface();
+
+	bool same = true;
+	for(int y = 0; y < surfaceA->h && same; ++y)
+	{
+		const char* const rowA = static_cast<const char*>(surfaceA->pixels) + y * surfaceA->pitch;
+		const char* const rowB = static_cast<const char*>(surfaceB->pixels) + y * surfaceB->pitch;
+		same = (memcmp(rowA, rowB, surfaceA->w * surfaceA->format->BytesPerPixel) == 0);
+	}
+
+	SDL_FreeSurface(surfaceA);
+	SDL_FreeSurface(surfaceB);
+	return same;
+}
+
+TEST(tiled_renderer, matches_graphics_update)
+{
+	boost::minstd_rand rand(5);
+
+	for(unsigned long trial = 0; trial < 100; ++trial)
+	{
+		const Point size(50 + rand() % 500, 50 + rand() % 400);
+		const Scene scene(rand, size, 100);
+
+		const std::auto_ptr<Screen> expected(make_screen(size));
+		const std::auto_ptr<Screen> actual(make_screen(size));
+		Graphics::Background expectedBackground, actualBackground;
+		const Graphics::Camera camera(size);
+		Graphics::TiledRenderer renderer(1 + trial % 4, 1 + rand() % 70);
+
+		Graphics::Update(scene.graphicsObjects, scene.entities, expectedBackground, camera, *expected);
+		renderer.Update(scene.graphicsObjects, scene.entities, actualBackground, camera, *actual);
+
+		EXPECT_TRUE(same_pixels(*expected, *actual)) << "trial " << trial;
+	}
+}
+
+// the camera following a focus around a world bigger than the screen, so the backgrounds are kept between frames
+TEST(tiled_renderer, matches_graphics_update_while_scrolling)
+{
+	boost::minstd_rand rand(7);
+
+	const Point viewSize(320, 240);
+	const Point worldSize(2000, 1500);
+	const Scene scene(rand, worldSize, 3000);
+
+	const std::auto_ptr<Screen> expected(make_screen(viewSize));
+	const std::auto_ptr<Screen> actual(make_screen(viewSize));
+	Graphics::Background expectedBackground, actualBackground;
+	Graphics::Camera camera(viewSize);
+	Graphics::TiledRenderer renderer(3, 48);
+
+	Point focus(worldSize.x / 2, worldSize.y / 2);
+	for(unsigned long frame = 0; frame < 200; ++frame)
+	{
+		// mostly small steps, with the occasional jump
+		if(frame % 50 == 49)
+			focus = Point(rand() % worldSize.x, rand() % worldSize.y);
+		else
+			focus += Point(static_cast<long>(rand() % 41) - 20, static_cast<long>(rand() % 41) - 20);
+
+		camera.Follow(Bounds(focus, focus + Point(20, 20)), worldSize);
+
+		Graphics::Update(scene.graphicsObjects, scene.entities, expectedBackground, camera, *expected);
+		renderer.Update(scene.graphicsObjects, scene.entities, actualBackground, camera, *actual);
+
+		EXPECT_TRUE(same_pixels(*expected, *actual)) << "frame " << frame;
+	}
+}
+
+// a background kept between frames, shifted and drawn a strip at a time, against one drawn from scratch every frame
+TEST(tiled_renderer, background_matches_full_redraw_while_scrolling)
+{
+	boost::minstd_rand rand(9);
+
+	const Point viewSize(320, 240);
+	const Point worldSize(2000, 1500);
+	const Scene scene(rand, worldSize, 3000);
+
+	const std::auto_ptr<Screen> target(make_screen(viewSize));
+	Graphics::Background background;
+	Graphics::Camera camera(viewSize);
+
+	Point focus(worldSize.x / 2, worldSize.y / 2);
+	for(unsigned long frame = 0; frame < 200; ++frame)
+	{
+		// steps along one axis, both, or bigger than the view, and sometimes none at all
+		if(frame % 50 == 49)
+			focus = Point(rand() % worldSize.x, rand() % worldSize.y);
+		else if(frame % 10 != 9)
+		{
+			const long dx = static_cast<long>(rand() % 41) - 20, dy = static_cast<long>(rand() % 41) - 20;
+			focus += Point(dx, frame % 3 == 0 ? 0 : dy);
+		}
+
+		camera.Follow(Bounds(focus, focus + Point(20, 20)), worldSize);
+
+		Graphics::Background fresh;
+		background.Refresh(scene.graphicsObjects, camera, *target);
+		fresh.Refresh(scene.graphicsObjects, camera, *target);
+
+		EXPECT_TRUE(same_pixels(fresh.GetScreen(), background.GetScreen())) << "frame " << frame;
+	}
+}
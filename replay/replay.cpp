@@ -0,0 +1,65 @@
+// Replays a recording made with "GingerbreadPrototype --record", headlessly and as fast as possible,
+// checking the game's state after every tick against the recorded one. This doubles as a benchmark
+// of the whole simulation, driven by a real game. Replays must use the config the game was recorded
+// with (and config reloads during the recording aren't recorded).
+//
+// usage: snake_replay recording [config]
+// which defaults to game.cfg. Exits with 1 if the replay diverges from the recording.
+
+#include "../main/Config.hpp"
+#include "../main/GameWorld.hpp"
+#include "../main/InputPlayer.hpp"
+#include "../main/ZippedUniqueObjectCollection.hpp"
+
+#ifdef MSVC
+#pragma warning(push, 0)
+#endif
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstdio>
+#include <string>
+
+#ifdef MSVC
+#pragma warning(pop)
+#endif
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s recording [config]\n", argv[0]);
+		return 1;
+	}
+
+	InputPlayer player(argv[1]);
+	if(!player.IsValid())
+	{
+		fprintf(stderr, "Unable to play \"%s\"\n", argv[1]);
+		return 1;
+	}
+
+	const std::string configFilename = (argc > 2) ? argv[2] : "game.cfg";
+	const GameWorld::ConfigPtr config(new Config(Config::GetConfigLoader(configFilename)));
+
+	ZippedUniqueObjectCollection gameObjects;
+	GameWorld world(config, gameObjects, player.GetSeed());
+
+	const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+	StateHash::ValueType expectedHash;
+	while(player.Step(world, expectedHash))
+	{
+		if(world.GetStateHash() != expectedHash)
+		{
+			fprintf(stderr, "Diverged from the recording at tick %llu\n", world.GetTick() - 1);
+			return 1;
+		}
+	}
+
+	const double seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+	const GameWorld::TickType ticks = world.GetTick();
+
+	printf("Replayed %llu ticks (%.1fs of game time) in %.3fs: %.0f ticks/s\n", ticks,
+		ticks * GameWorld::tickLength / 1000.0, seconds, (seconds > 0) ? ticks / seconds : 0.0);
+	return 0;
+}